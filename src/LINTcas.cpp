@@ -17,62 +17,101 @@ Original R code by Rob van den Beuken; rob.vandenbeuken@wur.nl; (c) 2019, PPS
 
 
 void LINcasModel::states() {
-	S.ROOTD = S.ROOTD + R.ROOTD;
-	S.WA = S.WA + R.WA;
-	S.TSUM = S.TSUM + R.TSUM;
-	S.TSUMCROP = S.TSUMCROP + R.TSUMCROP;
-	S.TSUMCROPLEAFAGE = S.TSUMCROPLEAFAGE + R.TSUMCROPLEAFAGE;
-	S.DORMTSUM = S.DORMTSUM + R.DORMTSUM;
-	S.PUSHDORMRECTSUM = S.PUSHDORMRECTSUM + R.PUSHDORMRECTSUM;
-	S.PUSHREDISTENDTSUM = S.PUSHREDISTENDTSUM + R.PUSHREDISTENDTSUM;
-	S.DORMTIME = S.DORMTIME + R.DORMTIME;
-	S.WCUTTING = S.WCUTTING + R.WCUTTING;
-	//S.TRAIN = S.TRAIN + R.TRAIN;
-	S.PAR = S.PAR + R.PAR;
-	S.LAI = S.LAI + R.LAI;
-	S.WLVD = S.WLVD + R.WLVD;
-	S.WLV = S.WLV + R.WLV;
-	S.WST = S.WST + R.WST;
-	S.WSO = S.WSO + R.WSO;
-	S.WRT = S.WRT + R.WRT;
-	S.WLVG = S.WLVG + R.WLVG;
-	S.TRAN = S.TRAN + R.TRAN;
-	S.EVAP = S.EVAP + R.EVAP;
-	S.PTRAN = S.PTRAN + R.PTRAN;
-	S.PEVAP = S.PEVAP + R.PEVAP;
-	S.RUNOFF = S.RUNOFF + R.RUNOFF;
-	S.NINTC = S.NINTC + R.NINTC;
-	S.DRAIN = S.DRAIN + R.DRAIN;
-	S.IRRIG = S.IRRIG + R.IRRIG;
-	S.REDISTLVG = S.REDISTLVG + R.REDISTLVG;
-	S.REDISTSO = S.REDISTSO + R.REDISTSO;
-	S.PUSHREDISTSUM = S.PUSHREDISTSUM + R.PUSHREDISTSUM;
-	S.WSOFASTRANSLSO = S.WSOFASTRANSLSO + R.WSOFASTRANSLSO;
+	// TRAIN is only used in the NPK model
+#define LC_UPDATE(name, npk) if (!npk) S.name = S.name + R.name * DELT;
+	LC_VARIABLES(LC_UPDATE)
+#undef LC_UPDATE
 }
 
 void LINcasModel::output(){
-	
-	if (control.outvars == "batch") {
-		return;
-//		out.values.insert(out.values.end(), {double(step), S.WSO});
-	} else if (control.outvars == "states") {
-		out.values.insert(out.values.end(),
-			{ double(step), S.ROOTD, S.WA, S.TSUM, S.TSUMCROP, S.TSUMCROPLEAFAGE, S.DORMTSUM, 
-			S.PUSHDORMRECTSUM, S.PUSHREDISTENDTSUM, S.DORMTIME, S.WCUTTING, S.PAR, S.LAI, 
-			S.WLVD, S.WLV, S.WST, S.WSO, S.WRT, S.WLVG, S.TRAN, S.EVAP, S.PTRAN, S.PEVAP, 
-			S.RUNOFF, S.NINTC, S.DRAIN, S.REDISTLVG, S.REDISTSO, S.PUSHREDISTSUM, S.WSOFASTRANSLSO, S.IRRIG });
-	} else { // full
-		out.values.insert(out.values.end(),
-			{ double(step), S.ROOTD, S.WA, S.TSUM, S.TSUMCROP, S.TSUMCROPLEAFAGE, S.DORMTSUM, 
-			S.PUSHDORMRECTSUM, S.PUSHREDISTENDTSUM, S.DORMTIME, S.WCUTTING, S.PAR, S.LAI, 
-			S.WLVD, S.WLV, S.WST, S.WSO, S.WRT, S.WLVG, S.TRAN, S.EVAP, S.PTRAN, S.PEVAP, 
-			S.RUNOFF, S.NINTC, S.DRAIN, S.REDISTLVG, S.REDISTSO, S.PUSHREDISTSUM, S.WSOFASTRANSLSO, S.IRRIG,
-
-			R.ROOTD, R.WA, R.TSUM, R.TSUMCROP, R.TSUMCROPLEAFAGE, R.DORMTSUM, 
-			R.PUSHDORMRECTSUM, R.PUSHREDISTENDTSUM, R.DORMTIME, R.WCUTTING, R.PAR, R.LAI, 
-			R.WLVD, R.WLV, R.WST, R.WSO, R.WRT, R.WLVG, R.TRAN, R.EVAP, R.PTRAN, R.PEVAP, 
-			R.RUNOFF, R.NINTC, R.DRAIN, R.REDISTLVG, R.REDISTSO, R.PUSHREDISTSUM, R.WSOFASTRANSLSO, R.IRRIG	});
+	// out.variables is empty for "batch" output 
+	if (out.variables.empty()) return;
+	out.values.push_back(double(step));
+	for (const LINcasOutputVariable &v : out.variables) {
+		out.values.push_back(v.rate ? R.*v.value : S.*v.value);
+	}
+}
+
+
+// "events" output; called by rates() and ratesNPK() after emergence
+void LINcasModel::logEvents(bool DORMANCY, bool PUSHREDIST, double TRANRF, double NPKI) {
+	unsigned &f = eventlog.flags;
+	auto log = [this](LINcasOutputEvent e, double value) {
+		out.values.insert(out.values.end(), {double(step), double(e), value});
+	};
+	if (!(f & (1 << LC_EMERGENCE))) {
+		f |= 1 << LC_EMERGENCE;
+		log(LC_EMERGENCE, S.TSUM);
+	}
+	if (DORMANCY != bool(f & (1 << LC_DORMANCY_START))) {
+		f ^= 1 << LC_DORMANCY_START;
+		if (DORMANCY) {
+			eventlog.dormancy = step;
+			log(LC_DORMANCY_START, S.LAI);
+		} else {
+			log(LC_DORMANCY_END, step - eventlog.dormancy);
+		}
+	}
+	if (PUSHREDIST != bool(f & (1 << LC_REDIST_START))) {
+		f ^= 1 << LC_REDIST_START;
+		if (PUSHREDIST) {
+			eventlog.redist = step;
+			log(LC_REDIST_START, S.WSO);
+		} else {
+			log(LC_REDIST_END, step - eventlog.redist);
+		}
+	}
+	if ((TRANRF < 1) && !(f & (1 << LC_DROUGHT_STRESS))) {
+		f |= 1 << LC_DROUGHT_STRESS;
+		log(LC_DROUGHT_STRESS, TRANRF);
 	}
+	if ((NPKI < 1) && !(f & (1 << LC_NUTRIENT_STRESS))) {
+		f |= 1 << LC_NUTRIENT_STRESS;
+		log(LC_NUTRIENT_STRESS, NPKI);
+	}
+}
+
+
+// Before emergence only the temperature sum and the soil water balance change, 
+// and the crop rates are zero. These days are simulated with this reduced
+// version of rates() and states() that gives the same states. It returns false,
+// without changing anything, if the crop emerges on this day
+bool LINcasModel::preemergence_step() {
+
+	double WC = 0.001 * S.WA/S.ROOTD;	 // (-) 
+	if ((S.TSUM >= crop.FINTSUM) || ((WC > soil.WCWP) && (S.TSUM >= crop.OPTEMERGTSUM))) {
+		return false;
+	}
+	double DTEFF  = std::max(0., A.TAVG - crop.TBASE); // Deg. C
+	R.PAR  = crop.FPAR * A.SRAD;
+	double PLANTED = calendar.fraction(A.date, DELT, LC_PLANTED);
+	R.TSUM = (PLANTED > 0) ? DTEFF * PLANTED : 0;
+	R.TSUMCROP = 0;
+	R.ROOTD = 0;
+
+	R.NINTC = std::min(A.PREC, (crop.FRACRNINTC * S.LAI)) ;
+	Penman();
+	double WCSD = soil.WCWP * crop.TWCSD;
+	double WCCR = soil.WCWP + std::max(WCSD-soil.WCWP, 
+		(R.PTRAN/(R.PTRAN+crop.TRANCO) * (soil.WCFC-soil.WCWP)));
+	evaptr();
+	drunir(WC, WCCR);
+	// EXPLOR is zero
+	R.WA = (A.PREC + 0. + R.IRRIG) - (R.NINTC + R.RUNOFF + R.TRAN + R.EVAP + R.DRAIN);
+
+	output();
+	S.TSUM += R.TSUM * DELT;
+	S.PAR += R.PAR * DELT;
+	S.WA += R.WA * DELT;
+	S.NINTC += R.NINTC * DELT;
+	S.PTRAN += R.PTRAN * DELT;
+	S.PEVAP += R.PEVAP * DELT;
+	S.TRAN += R.TRAN * DELT;
+	S.EVAP += R.EVAP * DELT;
+	S.RUNOFF += R.RUNOFF * DELT;
+	S.DRAIN += R.DRAIN * DELT;
+	S.IRRIG += R.IRRIG * DELT;
+	return true;
 }
 
 
@@ -87,7 +126,8 @@ void LINcasModel::rates() {
 	R.PAR  = crop.FPAR * A.SRAD;        // PAR MJ m-2 d-1   : PAR radiation
 
     // Temperature sum after planting;
-	R.TSUM = (management.PLDATE <= A.date) ? DTEFF : 0; // Deg. C 
+	double PLANTED = calendar.fraction(A.date, DELT, LC_PLANTED); // (-) of the time step
+	R.TSUM = (PLANTED > 0) ? DTEFF * PLANTED : 0; // Deg. C 
 
 	// Determine water content of rooted soil
 	double WC = 0.001 * S.WA/S.ROOTD;	 // (-) 
@@ -136,12 +176,13 @@ void LINcasModel::rates() {
 	double TRANRF = R.PTRAN <= 0 ? 1 : R.TRAN/R.PTRAN; // (-)
 
 	// Drainage and Runoff is calculated using the drunir function.
-	drunir(); // compute R.DRAIN and R.RUNOFF  // mm d-1
+	drunir(WC, WCCR); // compute R.DRAIN, R.RUNOFF and R.IRRIG  // mm d-1
 	
 	// Rate of change of soil water amount;
 	R.WA = (A.PREC + EXPLOR + R.IRRIG) - (R.NINTC + R.RUNOFF + R.TRAN + R.EVAP + R.DRAIN);  // mm d-1;
 
 	if (!EMERG) return;
+	emerged = true;
 
 //---DORMANCY AND RECOVERY-------------------------------------------//;
 	// The crop enters the dormancy phase as the soil water content is lower than the soil water content at ;
@@ -168,18 +209,19 @@ void LINcasModel::rates() {
 	bool DORMANCY = (dormancy || PUSHDORMREC) && (!PUSHREDIST) && ((S.TSUMCROP - crop.TSUMSBR) >= 0);
 
 	// The temperature sums related to the dormancy and recovery periods.
-	R.DORMTSUM = DTEFF * DORMANCY - (S.DORMTSUM/control.DELT) * PUSHREDIST; // Deg. C
-	R.PUSHDORMRECTSUM = DTEFF * PUSHDORMREC - (S.PUSHDORMRECTSUM/control.DELT) * (!(PUSHDORMREC || PUSHREDIST));  // Deg. C;
+	R.DORMTSUM = DTEFF * DORMANCY - (S.DORMTSUM/DELT) * PUSHREDIST; // Deg. C
+	R.PUSHDORMRECTSUM = DTEFF * PUSHDORMREC - (S.PUSHDORMRECTSUM/DELT) * (!(PUSHDORMREC || PUSHREDIST));  // Deg. C;
 	
-	R.PUSHREDISTSUM = DTEFF * PUSHREDIST - (S.PUSHREDISTSUM/control.DELT) * PUSHREDISTEND;  // Deg. C
-	R.PUSHREDISTENDTSUM = DTEFF * PUSHREDIST - (S.PUSHREDISTENDTSUM/control.DELT) * (!PUSHREDISTEND); // Deg. C
+	R.PUSHREDISTSUM = DTEFF * PUSHREDIST - (S.PUSHREDISTSUM/DELT) * PUSHREDISTEND;  // Deg. C
+	R.PUSHREDISTENDTSUM = DTEFF * PUSHREDIST - (S.PUSHREDISTENDTSUM/DELT) * (!PUSHREDISTEND); // Deg. C
 
 	// No. of days in dormancy
 	R.DORMTIME = DORMANCY;  // d
 
 	// Dry matter redistribution after dormancy. The rate of redistribution of the storage roots dry matter to leaf dry matter. A certain fraction is lost for the conversion of storage organs dry matter to leaf dry matter.
-	R.REDISTSO = crop.RRREDISTSO * S.WSO * PUSHREDIST - (S.REDISTSO/control.DELT) * (S.DORMTSUM > 0); // g DM m-2 d-1
+	R.REDISTSO = crop.RRREDISTSO * S.WSO * PUSHREDIST - (S.REDISTSO/DELT) * (S.DORMTSUM > 0); // g DM m-2 d-1
 	R.REDISTLVG = crop.SO2LV * R.REDISTSO * (!DORMANCY);  // g DM m-2 d-1
+	if (out.events) logEvents(DORMANCY, PUSHREDIST, TRANRF, 1);
  
 //---LIGHT INTERCEPTION AND GROWTH-----------------------------------------//
 	// Light interception and total crop growth rate.
@@ -192,7 +234,7 @@ void LINcasModel::rates() {
 
 //--- AGE;
 	// The calculation of the physiological leaf age.  ;
-	R.TSUMCROPLEAFAGE = DTEFF * EMERG - (S.TSUMCROPLEAFAGE/control.DELT) * PUSHREDIST;     // Deg. C
+	R.TSUMCROPLEAFAGE = DTEFF * EMERG - (S.TSUMCROPLEAFAGE/DELT) * PUSHREDIST;     // Deg. C
 
 	// Relative death rate due to aging depending on leaf age and the daily average temperature.
 	double RDRDV = (S.TSUMCROPLEAFAGE >= crop.TSUMLLIFE) ? approx(crop.RDRT, A.TAVG) : 0; // d-1
@@ -256,11 +298,12 @@ void LINcasModel::rates() {
 
 	// Stem cutting partioning at emergence. ;
 	if (EMERG && (S.WST == 0)) {
-		R.WCUTTING = S.WCUTTING *(-crop.FST_CUTT - crop.FRT_CUTT - crop.FLV_CUTT - crop.FSO_CUTT) ;
-		R.WRT = crop.WCUTTINGIP * crop.FRT_CUTT;	// g fibrous root DM m-2 d-1
-		R.WST = crop.WCUTTINGIP * crop.FST_CUTT;	// g stem DM m-2 d-1
-		R.WLVG = crop.WCUTTINGIP * crop.FLV_CUTT;     // g leaves DM m-2 d-1
-		R.WSO  = crop.WCUTTINGIP * crop.FSO_CUTT;     // g storage root DM m-2 d-1
+		// these are amounts that are allocated in one time step
+		R.WCUTTING = S.WCUTTING *(-crop.FST_CUTT - crop.FRT_CUTT - crop.FLV_CUTT - crop.FSO_CUTT) / DELT;
+		R.WRT = crop.WCUTTINGIP * crop.FRT_CUTT / DELT;	// g fibrous root DM m-2 d-1
+		R.WST = crop.WCUTTINGIP * crop.FST_CUTT / DELT;	// g stem DM m-2 d-1
+		R.WLVG = crop.WCUTTINGIP * crop.FLV_CUTT / DELT;     // g leaves DM m-2 d-1
+		R.WSO  = crop.WCUTTINGIP * crop.FSO_CUTT / DELT;     // g storage root DM m-2 d-1
 	} else if (S.TSUM > crop.OPTEMERGTSUM) {	
 		R.WCUTTING = -crop.RDRWCUTTING * S.WCUTTING * ((S.WCUTTING-WCUTTINGMIN) >= 0) * TRANRF * EMERG * (!DORMANCY);  // g stem cutting DM m-2 d-1;
 		R.WRT   = (std::abs(GTOTAL) + std::abs(R.WCUTTING)) * FRT;	// g fibrous root DM m-2 d-1
@@ -290,10 +333,10 @@ void LINcasModel::rates() {
 		GLAI =  0;     // m2 m-2 d-1
 	} else if ((S.LAI == 0) && (WC > soil.WCWP)) {
 		// Growth at day of seedling emergence
-		GLAI =  crop.LAII / control.DELT;  // m2 m-2 d-1
+		GLAI =  crop.LAII / DELT;  // m2 m-2 d-1
 	} else if ((S.TSUMCROP < crop.TSUMLA_MIN) && (S.LAI < crop.LAIEXPOEND)) {
 		 // Growth during juvenile stage
-		GLAI = ((S.LAI * (std::exp(crop.RGRL * DTEFF * control.DELT) - 1) / control.DELT) 
+		GLAI = ((S.LAI * (std::exp(crop.RGRL * DTEFF * DELT) - 1) / DELT) 
 				+ std::abs(R.WCUTTING) * FLV * SLA) * TRANRF;  // m2 m-2 d-1
 	} else {
 		GLAI = SLA * GLV * (!DORMANCY);  // m2 m-2 d-1  
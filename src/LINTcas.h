@@ -5,21 +5,149 @@ License: GNU General Public License (GNU GPL) v. 2
 */
 
 #include <vector>
+#include <array>
 #include <cmath>
 #include <string>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <random>
+#include "schema.h"
 
-class LINcasWeather {
+
+// read-only view of a contiguous array that is owned by someone else
+template <class T>
+class LINcasSpan {
 public:
-	virtual ~LINcasWeather(){}
+	LINcasSpan() {}
+	LINcasSpan(const T* p, size_t n) : ptr(p), n(n) {}
+	LINcasSpan(const std::vector<T> &v) : ptr(v.data()), n(v.size()) {}
+	const T& operator[](size_t i) const { return ptr[i]; }
+	size_t size() const { return n; }
+	const T* data() const { return ptr; }
+	const T* begin() const { return ptr; }
+	const T* end() const { return ptr + n; }
+private:
+	const T* ptr=nullptr;
+	size_t n=0;
+};
+
+
+// daily weather series. Created once (e.g. when registered from R) and then 
+// shared, read-only, by all models that use it 
+class LINcasWeatherData {
+public:
+	virtual ~LINcasWeatherData(){}
 	std::vector<long> date;
 	std::vector<double> srad, tmin, tmax, prec, wind, vapr;
+	bool check(std::string &msg) const;
+	// from a csv file with variables date, srad, tmin, tmax, prec, wind and vapr
+	bool read(const std::string &filename, std::string &msg);
+};
+
+// Daily weather for the cells of a grid, in the layout of an R array with 
+// dimensions (cells, days, variables); the cells vary fastest. The variables
+// are srad, tmin, tmax, prec, wind and vapr. The values are not copied
+class LINcasWeatherCube {
+public:
+	const double* values=nullptr;
+	size_t ncells=0;
+	std::vector<long> date;
+	double get(size_t cell, size_t day, size_t var) const {
+		return values[cell + ncells * (day + date.size() * var)];
+	}
 };
 
+// the zones (and weights) for the aggregation of the output of a grid run
+class LINcasZones {
+public:
+	std::vector<int> id; // for each cell; < 0 (or NA) if the cell is not in a zone
+	std::vector<double> weight; // for each cell (e.g. the crop area); empty for equal weights
+	std::vector<double> probs; // of the quantiles
+};
+
+// the weather of one day
+struct LINcasDay {
+	double srad, tmin, tmax, prec, wind, vapr;
+};
+
+// Stochastic daily weather generator, fitted to a weather series. For each month: 
+// a first order Markov chain for precipitation occurrence, gamma distributed 
+// precipitation amounts, and the mean and standard deviation of the other 
+// variables on dry and wet days. Their standardized residuals are AR(1) processes
+class LINcasWeatherGenerator {
+public:
+	bool fit(const LINcasWeatherData &w, std::string &msg);
+	static const int nvars = 5; // tmin, tmax, srad, vapr, wind
+	double pwd[12], pww[12]; // probability of a wet day after a dry and a wet day
+	double shape[12], scale[12]; // gamma distribution of precipitation on wet days
+	double mean[12][2][nvars], sd[12][2][nvars]; // by month and dry/wet
+	// the standardized residuals of day t are z(t) = A z(t-1) + B e(t), with e 
+	// independent standard normal, such that they have the lag-0 and lag-1 
+	// (cross) correlations of the data (B is lower triangular)
+	double A[nvars][nvars], B[nvars][nvars];
+};
+
+// the state of a generator for a weather sequence ("member")
+class LINcasGeneratorState {
+public:
+	void seed(uint64_t s);
+	void next(const LINcasWeatherGenerator &g, long date, LINcasDay &d);
+	// the state as text (for checkpoints), and back
+	std::string str() const;
+	bool set(const std::string &s);
+private:
+	std::mt19937_64 rng;
+	bool wet=false;
+	double z[LINcasWeatherGenerator::nvars] = {0};
+};
+
+// Climate change scenario: monthly changes that are applied to the weather 
+// of each day when it is used. The weather data are not changed or copied
+class LINcasWeatherTransform {
+public:
+	LINcasWeatherTransform();
+	double dtmin[12], dtmax[12]; // added (degrees C)
+	double fsrad[12], fprec[12], fwind[12], fvapr[12]; // multiplied
+	bool rh=false; // keep the relative humidity (vapr changes with temperature)
+	void apply(long date, LINcasDay &d) const;
+};
+
+// the weather as seen by a model; a view on shared LINcasWeatherData
+class LINcasWeather {
+public:
+	virtual ~LINcasWeather(){}
+	LINcasSpan<long> date;
+	LINcasSpan<double> srad, tmin, tmax, prec, wind, vapr;
+	void set(std::shared_ptr<const LINcasWeatherData> d);
+	// the days of d from index "from" onwards
+	void set(std::shared_ptr<const LINcasWeatherData> d, size_t from);
+	std::shared_ptr<const LINcasWeatherData> data; // keeps the viewed data alive
+	// if not null, the weather for the dates is generated (with seed) instead of read from data
+	std::shared_ptr<const LINcasWeatherGenerator> generator;
+	uint64_t seed=0;
+	// if not null, a scenario that is applied to the weather (data or generated)
+	std::shared_ptr<const LINcasWeatherTransform> transform;
+	void get(size_t i, LINcasDay &d) const {
+		d = {srad[i], tmin[i], tmax[i], prec[i], wind[i], vapr[i]};
+	}
+};
+
+// the month (0-11) of a date (days since 1970-01-01)
+int LC_month(long date);
+// the date (days since 1970-01-01) of a year, month (1-12) and day
+long LC_date(long y, long m, long d);
+std::string LC_date_string(long date);
+
 class LINcasAtmosphere {
 public:
 	virtual ~LINcasAtmosphere(){}
 	long date;
 	double TAVG, PREC, VPD_MN, VPD_MX, SRAD, VAPR, WIND; 
+	// the terms of the Penman equation that do not depend on the crop (J m-2 d-1): 
+	// radiation for soil and crop, and drying power (see penmanTerms)
+	double PENMRS, PENMRC, PENMD;
+	void penmanTerms();
 };
 
 
@@ -32,139 +160,89 @@ public:
 	bool water_limited=false;	
 	bool nutrient_limited=false;	
 	double WCI; // not yet used
-	std::string outvars;
+	std::string outvars; // "batch", "states", "full", "events", or "custom"
+	std::vector<std::string> outnames; // variables for "custom" output ("R" prefix for rates)
 };
 
 
+// A parameter table (a vector of columns). The values cannot be changed, but 
+// a new table can be assigned. Copies share the data, so copying parameters 
+// does not copy the tables
+class LINcasTable {
+public:
+	LINcasTable() {}
+	LINcasTable(std::vector<std::vector<double>> x) : d(std::make_shared<const std::vector<std::vector<double>>>(std::move(x))) {}
+	const std::vector<double>& operator[](size_t i) const { return (*d)[i]; }
+	size_t size() const { return d ? d->size() : 0; }
+	std::vector<std::vector<double>> values() const { return d ? *d : std::vector<std::vector<double>>(); }
+	bool shares(const LINcasTable &x) const { return d == x.d; }
+private:
+	std::shared_ptr<const std::vector<std::vector<double>>> d;
+};
+
+// the parameter and variable names are in schema.h
+#define LC_DOUBLE(name) double name;
+#define LC_DOUBLE0(name) double name=0;
+#define LC_TABLE(name, ncol) LINcasTable name;
+
 class LINcasCropParameters {
 public:
 	virtual ~LINcasCropParameters(){}	
-	double TWCSD, FRACRNINTC, RECOV, TRANCO, WCUTTINGUNIT, NCUTTINGS, WCUTTINGIP, ROOTDI, SLAI, WLVI, LAII, WCUTTINGMINPRO, FST_CUTT, FRT_CUTT, FLV_CUTT, FSO_CUTT, RDRWCUTTING, FPAR, K_EXT, LUE_OPT, RRDMAX, RDRB, LAICR, RDRSHM, FRACTLLFENHSH, FASTRANSLSO, SLA_MAX, RGRL, LAIEXPOEND, TBASE, OPTEMERGTSUM, TSUMLA_MIN, TSUMSBR, TSUMLLIFE, TSUMREDISTMAX, FINTSUM, LAI_MIN, WSOREDISTFRACMAX, WLVGNEWN, SO2LV, RRREDISTSO, DELREDIST, SLAII;
-	std::vector<std::vector<double>> FRACSLATB, RDRT, TTB, FLVTB, FSTTB, FSOTB, FRTTB;
+	LC_CROP_PARAMETERS(LC_DOUBLE)
+	LC_CROP_TABLES(LC_TABLE)
 
 // nutrients	
-	double NLAI, RDRNS, K_MAX, K_NPK_NI, TSUM_NPKI, K_WATER, SLOPE_NEQ_SOILSUPPLY_NEQ_PLANTUPTAKE, FR_MAX, N_RECOV, P_RECOV, K_RECOV, NFLVD, PFLVD, KFLVD, TCNPKT, RTNMINF, RTPMINF, RTKMINF;
-	std::vector<std::vector<double>> NMINMAXLV, PMINMAXLV, KMINMAXLV, NMINMAXST, PMINMAXST, KMINMAXST, NMINMAXSO, PMINMAXSO, KMINMAXSO, NMINMAXRT, PMINMAXRT, KMINMAXRT;
-
+	LC_CROP_NPK_PARAMETERS(LC_DOUBLE)
+	LC_CROP_NPK_TABLES(LC_TABLE)
 } ;
 
 class LINcasSoilParameters {
 public:
 	virtual ~LINcasSoilParameters(){}
-
-	double ROOTDM, WCAD, WCWP, WCFC, WCWET, WCST, DRATE;
+	LC_SOIL_PARAMETERS(LC_DOUBLE)
 
 // nutrients	
-	double NMINI=0, PMINI=0, KMINI=0, RTNMINS=0, RTPMINS=0, RTKMINS=0;
+	LC_SOIL_NPK_PARAMETERS(LC_DOUBLE0)
+	double RTNMINS=0, RTPMINS=0, RTKMINS=0;
 };
 
 
-class LINcasRates {
-public:
-	double ROOTD=0; // m d-1
-	double WA=0;   // mm d-1  
-	double TSUM=0; double TSUMCROP=0; // Deg. C d-1
-	double TSUMCROPLEAFAGE=0; double DORMTSUM=0;// Deg. C d-1
-	double PUSHDORMRECTSUM=0; double PUSHREDISTENDTSUM=0; // Deg. C d-1
-	double DORMTIME=0; // d d-1
-	double WCUTTING=0; // g DM m-2 d-1
-	double TRAIN=0;// mm d-1
-	double PAR=0;// MJ m-2 d-1
-	double LAI=0;// m2 m-2 d-1
-	double WLVD=0; double WLV=0; double WST=0; double WSO=0; double WRT=0; double WLVG=0; // g DM m-2 d-1
-	double TRAN=0; double EVAP=0; double PTRAN=0; double PEVAP=0; 
-	double RUNOFF=0; double NINTC=0; double DRAIN=0; // mm d-1
-	double REDISTLVG=0; double REDISTSO=0;// g DM m-2 d-1
-	double PUSHREDISTSUM=0;// Deg. C d-1
-	double WSOFASTRANSLSO=0; // g DM m-2 d-1
-	double IRRIG=0;
-
-	double NCUTTING=0;
-	double PCUTTING=0;
-	double KCUTTING=0;
-	double ANLVG=0; // g N m-2 d-1
-	double ANLVD=0;
-	double ANST=0;
-	double ANRT=0;
-	double ANSO=0;
-	double APLVG=0; // g P m-2 d-1
-	double APLVD=0;
-	double APST=0;
-	double APRT=0;
-	double APSO=0;
-	double AKLVG=0; // g K m-2 d-1
-	double AKLVD=0;
-	double AKST=0;
-	double AKRT=0;
-	double AKSO=0;
-	double NMINT=0; // g N,P,K m-2 d-1
-	double PMINT=0;
-	double KMINT=0;
-	double NMINS=0; // g N,P,K m-2 d-1
-	double PMINS=0;
-	double KMINS=0;
-	double NMINF=0; // # g N,P,K m-2 d-1
-	double PMINF=0;
-	double KMINF=0;
-};
+// the state variables, and their rates of change
+#define LC_VARIABLE(name, npk) double name=0;
 
-class LINcasStates {
+class LINcasVariables {
 public:
-	double ROOTD=0; // m d-1
-	double WA=0;   // mm d-1  
-	double TSUM=0; double TSUMCROP=0; // Deg. C d-1
-	double TSUMCROPLEAFAGE=0; double DORMTSUM=0;// Deg. C d-1
-	double PUSHDORMRECTSUM=0; double PUSHREDISTENDTSUM=0; // Deg. C d-1
-	double DORMTIME=0; // d d-1
-	double WCUTTING=0; // g DM m-2 d-1
-	double TRAIN=0;// mm d-1
-	double PAR=0;// MJ m-2 d-1
-	double LAI=0;// m2 m-2 d-1
-	double WLVD=0; double WLV=0; double WST=0; double WSO=0; double WRT=0; double WLVG=0; // g DM m-2 d-1
-	double TRAN=0; double EVAP=0; double PTRAN=0; double PEVAP=0; 
-	double RUNOFF=0; double NINTC=0; double DRAIN=0; // mm d-1
-	double REDISTLVG=0; double REDISTSO=0;// g DM m-2 d-1
-	double PUSHREDISTSUM=0;// Deg. C d-1
-	double WSOFASTRANSLSO=0; // g DM m-2 d-1
-	double IRRIG=0;
-
-	double NCUTTING=0;
-	double PCUTTING=0;
-	double KCUTTING=0;
-	double ANLVG=0; // g N m-2 d-1
-	double ANLVD=0;
-	double ANST=0;
-	double ANRT=0;
-	double ANSO=0;
-	double APLVG=0; // g P m-2 d-1
-	double APLVD=0;
-	double APST=0;
-	double APRT=0;
-	double APSO=0;
-	double AKLVG=0; // g K m-2 d-1
-	double AKLVD=0;
-	double AKST=0;
-	double AKRT=0;
-	double AKSO=0;
-	double NMINT=0; // g N,P,K m-2 d-1
-	double PMINT=0;
-	double KMINT=0;
-	double NMINS=0; // g N,P,K m-2 d-1
-	double PMINS=0;
-	double KMINS=0;
-	double NMINF=0; // # g N,P,K m-2 d-1
-	double PMINF=0;
-	double KMINF=0;
-	
+	LC_VARIABLES(LC_VARIABLE)
 };
 
+class LINcasRates : public LINcasVariables {};
+class LINcasStates : public LINcasVariables {};
+
+#undef LC_VARIABLE
+#undef LC_DOUBLE
+#undef LC_DOUBLE0
+#undef LC_TABLE
+
 
+// a variable in the output; a state or a rate
+class LINcasOutputVariable {
+public:
+	double LINcasVariables::* value;
+	bool rate;
+};
 
 class LINcasOutput {
 public:
 	virtual ~LINcasOutput(){}
 	std::vector<std::string> names;
 	std::vector<double> values;
+	std::vector<LINcasOutputVariable> variables; // set by initialize
+	// the control settings used to set the variables
+	std::string outvars;
+	bool NPKmodel=false;
+	std::vector<std::string> outnames;
+	bool harvests=false;
+	bool events=false; // "events" output; see logEvents
 };
 
 
@@ -172,15 +250,85 @@ class LINcasManagement {
 public:
 	virtual ~LINcasManagement(){}
 	long PLDATE, HVDATE;
-	std::vector<std::vector<double>> FERTAB;
+	LINcasTable FERTAB;
+#define LC_DOUBLEV(name, value) double name=value;
+	LC_MANAGEMENT_OPTIONAL(LC_DOUBLEV)
+#undef LC_DOUBLEV
+	// multiple harvest dates (sorted), the last one is HVDATE. Empty if there is only one
+	std::vector<long> harvests; 
+	void setHarvest(std::vector<double> dates);
+};
+
+
+// The management events for each day of the simulation, compiled by start() 
+// so that a day does not need to search the management tables
+enum LINcasEvent : unsigned char {
+	LC_PLANTED = 1, // on or after the planting date
+	LC_FERTILIZE = 2,
+	LC_HARVEST = 4
+};
+
+class LINcasCalendar {
+public:
+	long first=0; // the date of the first day
+	std::vector<unsigned char> events; // LINcasEvent flags
+	std::vector<int> fertilizer; // the FERTAB row for each day, or -1
+	bool compile(const LINcasManagement &m, bool NPKmodel, long start, size_t ndays, std::vector<std::string> &messages);
+	unsigned char get(long date) const {
+		size_t i = date - first;
+		return (i < events.size()) ? events[i] : 0;
+	}
+	// the fraction of the days from date to date+ndays-1 with an event
+	double fraction(long date, unsigned ndays, unsigned char event) const {
+		unsigned n = 0;
+		for (unsigned i=0; i<ndays; i++) {
+			if (get(date + i) & event) n++;
+		}
+		return double(n) / ndays;
+	}
+	int fertrow(long date) const {
+		size_t i = date - first;
+		return (i < fertilizer.size()) ? fertilizer[i] : -1;
+	}
 };
 
 
+class LINcasSnapshot;
+
+// The "events" output has a row (step, event, value) for each event, instead of
+// a row for each day. The value is the TSUM at emergence, the LAI at the start
+// of dormancy, the WSO at the start of redistribution, the length (days) of a
+// dormancy or redistribution period at its end, TRANRF or NPKI on the first day
+// of drought or nutrient stress, and WSO at the end of the simulation
+enum LINcasOutputEvent {
+	LC_EMERGENCE = 1,
+	LC_DORMANCY_START,
+	LC_DORMANCY_END,
+	LC_REDIST_START,
+	LC_REDIST_END,
+	LC_DROUGHT_STRESS,
+	LC_NUTRIENT_STRESS,
+	LC_END
+};
+
+// the events that have happened, or the periods that are ongoing (bit 
+// 1 << event), and the step at which the current dormancy and redistribution 
+// periods started
+class LINcasEventLog {
+public:
+	unsigned flags=0;
+	unsigned dormancy=0, redist=0;
+};
+
 class LINcasModel {
 public:
 	virtual ~LINcasModel(){}
 
-	unsigned step, time, season_length;
+	unsigned step=0, time=0, season_length=0, maxdur=0;
+	size_t nextharvest=0; // index in management.harvests
+	bool ended=true; // no more days to simulate (or not started)
+	bool emerged=false; // the crop rates have been computed (see preemergence_step)
+	double DELT=1; // the days in the current time step; control.DELT, or less at the end
 
 	std::vector<std::string> messages;
 	bool fatalError=false;
@@ -193,27 +341,57 @@ public:
 	LINcasCropParameters crop;
 	LINcasManagement management;
 	LINcasControl control;
+	LINcasCalendar calendar; // set by start
 
 	LINcasOutput out;
+	LINcasEventLog eventlog;
+	LINcasGeneratorState wstate; // only used with generated weather
+	std::vector<double> harvestvalues; // see runHarvests
+	std::vector<std::string> harvestmessages;
+	unsigned unreliable=0; // the nutrients (bits) with an unbalanced reallocation; see nutrientdyn
 	
+	void weather_day(size_t i, LINcasDay &d);
+	unsigned step_length() const;
+	unsigned step_length(long until) const;
 	bool weather_step();
+	bool weather_step(unsigned days);
+	bool preemergence_step();
 	void rates();
 	void states();
 	void output();
+	void logEvents(bool DORMANCY, bool PUSHREDIST, double TRANRF, double NPKI);
+	void setOutput();
+	void reset();
 	void initialize(long int maxdur);
+	bool start(bool partial=false);
+	bool step_day();
+	bool step_day(long until);
+	bool crop_step();
+	void finish();
 	void run();
+	void harvest(long date);
+	void runHarvests();
+	bool multipleHarvests() const;
+
+	LINcasSnapshot snapshot() const;
+	void restore(const LINcasSnapshot &x);
+	std::vector<LINcasModel> fork(size_t n) const;
+
+	std::vector<unsigned char> checkpoint() const;
+	bool resume(const std::vector<unsigned char> &x, std::string &msg);
+	uint64_t parameterHash() const;
+	uint64_t weatherHash(size_t from, size_t to) const;
 
 	void ratesNPK();
 	void statesNPK();
-	void outputNPK();
 
 	void Penman();
 	void evaptr();
 	void GLAI();
-	void drunir();
+	void drunir(double WC, double WCCR);
 
 
-	std::vector<double> npkical(
+	std::array<double, 4> npkical(
 		double NMINLV, double PMINLV, double KMINLV,
 		double NMINST, double PMINST, double KMINST, 
 		double NMINSO, double PMINSO, double KMINSO, 
@@ -233,6 +411,117 @@ public:
 };
 
 
+// The state of a model at the start of a day; what is needed to continue 
+// a simulation with the same parameters and weather
+class LINcasSnapshot {
+public:
+	LINcasStates S;
+	LINcasRates R;
+	unsigned step=0, time=0, season_length=0, maxdur=0;
+	size_t nextharvest=0;
+	bool ended=true;
+	bool emerged=true; // if not known, the full daily rates are used
+	LINcasEventLog eventlog;
+	double RTNMINS=0, RTPMINS=0, RTKMINS=0; // set by initialize
+	LINcasGeneratorState wstate;
+};
+
+
+// Incremental simulation with weather that is extended and revised (e.g. every 
+// night). Snapshots are kept every "interval" days. An update continues from the 
+// last snapshot before the first day with different weather
+class LINcasNowcast {
+public:
+	LINcasModel model;
+	unsigned interval=7;
+	bool update(std::shared_ptr<const LINcasWeatherData> w, long today, std::string &msg);
+	size_t simulated=0; // days simulated in the last update
+
+	struct Point {
+		LINcasSnapshot x; // with "time" relative to the start of the simulation
+		size_t nout, nmsg; // the size of the output and messages
+	};
+	std::vector<Point> points; // at days 0, interval, 2*interval, ...
+	std::vector<uint64_t> days; // weather hash of each simulated day
+	uint64_t parameters=0; // parameter hash
+	size_t start=0; // index of the start date in the weather data
+};
+
+
+// name lookup with a perfect hash (no collisions for the names it was built with)
+class LINcasNameIndex {
+public:
+	LINcasNameIndex(const std::vector<std::string> &names);
+	int find(const char* name) const; // -1 if not found
+	int find(const std::string &name) const { return find(name.c_str()); }
+private:
+	std::vector<std::string> keys;
+	std::vector<int> slots;
+	uint32_t seed=0, mask=0;
+};
+
+
+// parameter descriptors generated from schema.h
+class LINcasParameter {
+public:
+	std::string name;
+	char group;  // 'c'rop, 's'oil, or 'm'anagement
+	bool npk;    // only used by the NPK model
+	size_t ncol; // 0 for a single value, otherwise the number of columns of a table
+	double LINcasCropParameters::* crop = nullptr;
+	double LINcasSoilParameters::* soil = nullptr;
+	long LINcasManagement::* date = nullptr;
+	double LINcasManagement::* mgmt = nullptr; // optional, with a default value
+	bool optional = false;
+	LINcasTable LINcasCropParameters::* croptable = nullptr;
+	LINcasTable LINcasManagement::* mgmttable = nullptr;
+
+	void set(LINcasModel &m, double v) const;
+	double get(const LINcasModel &m) const;
+	LINcasTable& table(LINcasModel &m) const;
+	const LINcasTable& table(const LINcasModel &m) const;
+};
+
+// Parameter values that replace those of a base model, e.g. for a job in a sweep.
+// Only the changed parameters are stored. The tables that are not changed are 
+// shared with the base model
+class LINcasOverlay {
+public:
+	std::vector<std::pair<int, double>> values; // index in LC_parameters() and value
+	std::vector<std::pair<int, LINcasTable>> tables;
+	void apply(const LINcasModel &base, LINcasModel &m) const;
+};
+
+
+class LINcasVariable {
+public:
+	std::string name;
+	bool npk;
+	double LINcasVariables::* value;
+};
+
+// the changes for run i of a set of runs (see LC_runs)
+typedef std::function<bool(size_t i, LINcasModel &m)> LINcasRunSetup;
+bool LC_runs(const LINcasModel &base, const std::string &key, const std::vector<double> &keys, size_t nthreads, const LINcasRunSetup &setup, LINcasOutput &out, std::vector<std::string> &messages);
+
+bool LC_planting_sweep(const LINcasModel &base, std::vector<long> dates, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages);
+bool LC_ensemble_forecast(const LINcasModel &base, long today, const std::vector<std::shared_ptr<const LINcasWeatherData>> &members, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages);
+bool LC_stochastic_runs(const LINcasModel &base, std::shared_ptr<const LINcasWeatherGenerator> g, size_t n, uint64_t seed, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages);
+bool LC_yield_gap(const LINcasModel &base, LINcasOutput &out, std::vector<std::string> &messages);
+bool LC_fertilizer_sweep(const LINcasModel &base, const std::vector<LINcasTable> &schedules, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages);
+bool LC_irrigation_sweep(const LINcasModel &base, const std::vector<std::array<double, 3>> &strategies, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages);
+bool LC_rotation(const LINcasModel &base, const std::vector<long> &plant, const std::vector<long> &harvest, const std::vector<std::string> &vars, const std::vector<std::string> &funs, LINcasOutput &out, std::vector<std::string> &messages);
+bool LC_screening(const LINcasModel &base, const std::vector<int> &index, const std::vector<std::vector<double>> &values, unsigned delt, const std::vector<size_t> &sample, double tolerance, size_t nthreads, LINcasOutput &out, double &calibration, std::vector<std::string> &messages);
+bool LC_grid_run(const LINcasModel &base, const LINcasWeatherCube &weather, const std::vector<int> &index, const std::vector<std::vector<double>> &values, const std::vector<int> &mask, const std::vector<std::string> &vars, size_t tile, size_t nthreads, std::vector<double> &out, std::vector<std::string> &messages);
+bool LC_grid_zonal(const LINcasModel &base, const LINcasWeatherCube &weather, const std::vector<int> &index, const std::vector<std::vector<double>> &values, const std::vector<int> &mask, const std::vector<std::string> &vars, const LINcasZones &zones, size_t tile, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages);
+bool LC_batch_run(const LINcasModel &base, const std::vector<std::string> &files, size_t nthreads, size_t prefetch, LINcasOutput &out, std::vector<std::string> &messages);
+
+const std::vector<LINcasParameter>& LC_parameters();
+int LC_parameter_index(const char* name);
+const std::vector<LINcasVariable>& LC_variables();
+int LC_variable_index(const char* name);
+
+
 
 inline double SatVP(const double &tmp) {
 	return 0.611 * std::exp(17.4 * tmp / (tmp + 239)) ;
@@ -240,7 +529,7 @@ inline double SatVP(const double &tmp) {
 
 
 
-inline double approx(std::vector<std::vector<double>> tb, double x) {
+inline double approx(const LINcasTable &tb, double x) {
 	int n = tb[0].size();
 	double y = NAN;
 	if (x <= tb[0][0]) {
@@ -259,7 +548,7 @@ inline double approx(std::vector<std::vector<double>> tb, double x) {
 	return(y);
 }	
 
-inline double approx2(std::vector<double> X, std::vector<double> Y, double v) {
+inline double approx2(const std::vector<double> &X, const std::vector<double> &Y, double v) {
 	int n = X.size();
 	double r = NAN;
 	if (v <= X[0]) {
@@ -18,100 +18,9 @@ Original R code by Rob van den Beuken; rob.vandenbeuken@wur.nl; (c) 2019, PPS
 
 
 void LINcasModel::statesNPK() {
-	S.ROOTD = S.ROOTD + R.ROOTD;
-	S.WA = S.WA + R.WA;
-	S.TSUM = S.TSUM + R.TSUM;
-	S.TSUMCROP = S.TSUMCROP + R.TSUMCROP;
-	S.TSUMCROPLEAFAGE = S.TSUMCROPLEAFAGE + R.TSUMCROPLEAFAGE;
-	S.DORMTSUM = S.DORMTSUM + R.DORMTSUM;
-	S.PUSHDORMRECTSUM = S.PUSHDORMRECTSUM + R.PUSHDORMRECTSUM;
-	S.PUSHREDISTENDTSUM = S.PUSHREDISTENDTSUM + R.PUSHREDISTENDTSUM;
-	S.DORMTIME = S.DORMTIME + R.DORMTIME;
-	S.WCUTTING = S.WCUTTING + R.WCUTTING;
-	//S.TRAIN = S.TRAIN + R.TRAIN;
-	S.PAR = S.PAR + R.PAR;
-	S.LAI = S.LAI + R.LAI;
-	S.WLVD = S.WLVD + R.WLVD;
-	S.WLV = S.WLV + R.WLV;
-	S.WST = S.WST + R.WST;
-	S.WSO = S.WSO + R.WSO;
-	S.WRT = S.WRT + R.WRT;
-	S.WLVG = S.WLVG + R.WLVG;
-	S.TRAN = S.TRAN + R.TRAN;
-	S.EVAP = S.EVAP + R.EVAP;
-	S.PTRAN = S.PTRAN + R.PTRAN;
-	S.PEVAP = S.PEVAP + R.PEVAP;
-	S.RUNOFF = S.RUNOFF + R.RUNOFF;
-	S.NINTC = S.NINTC + R.NINTC;
-	S.DRAIN = S.DRAIN + R.DRAIN;
-	S.IRRIG = S.IRRIG + R.IRRIG;
-	S.REDISTLVG = S.REDISTLVG + R.REDISTLVG;
-	S.REDISTSO = S.REDISTSO + R.REDISTSO;
-	S.PUSHREDISTSUM = S.PUSHREDISTSUM + R.PUSHREDISTSUM;
-	S.WSOFASTRANSLSO = S.WSOFASTRANSLSO + R.WSOFASTRANSLSO;
-	S.TRAIN = S.TRAIN + R.TRAIN;
-
-	S.NCUTTING = S.NCUTTING + R.NCUTTING;
-	S.PCUTTING = S.PCUTTING + R.PCUTTING;
-	S.KCUTTING = S.KCUTTING + R.KCUTTING;
-	S.ANLVG = S.ANLVG + R.ANLVG;
-	S.ANLVD = S.ANLVD + R.ANLVD;
-	S.ANST = S.ANST + R.ANST;
-	S.ANRT = S.ANRT + R.ANRT;
-	S.ANSO = S.ANSO + R.ANSO;
-	S.APLVG = S.APLVG + R.APLVG;
-	S.APLVD = S.APLVD + R.APLVD;
-	S.APST = S.APST + R.APST;
-	S.APRT = S.APRT + R.APRT;
-	S.APSO = S.APSO + R.APSO;
-	S.AKLVG = S.AKLVG + R.AKLVG;
-	S.AKLVD = S.AKLVD + R.AKLVD;
-	S.AKST = S.AKST + R.AKST;
-	S.AKRT = S.AKRT + R.AKRT;
-	S.AKSO = S.AKSO + R.AKSO;
-	S.NMINT = S.NMINT + R.NMINT;
-	S.PMINT = S.PMINT + R.PMINT;
-	S.KMINT = S.KMINT + R.KMINT;
-	S.NMINS = S.NMINS + R.NMINS;
-	S.PMINS = S.PMINS + R.PMINS;
-	S.KMINS = S.KMINS + R.KMINS;
-	S.NMINF = S.NMINF + R.NMINF;
-	S.PMINF = S.PMINF + R.PMINF;
-	S.KMINF = S.KMINF + R.KMINF;
-}
-
-void LINcasModel::outputNPK(){
-	
-	if (control.outvars == "batch") {
-		return;
-//		out.values.insert(out.values.end(), {double(step), S.WSO});
-	} else if (control.outvars == "states") {
-		out.values.insert(out.values.end(),
-				{ double(step), S.ROOTD, S.WA, S.TSUM, S.TSUMCROP, S.TSUMCROPLEAFAGE, S.DORMTSUM, 
-				S.PUSHDORMRECTSUM, S.PUSHREDISTENDTSUM, S.DORMTIME, S.WCUTTING, S.TRAIN, S.PAR, S.LAI, 
-				S.WLVD, S.WLV, S.WST, S.WSO, S.WRT, S.WLVG, S.TRAN, S.EVAP, S.PTRAN, S.PEVAP, 
-				S.RUNOFF, S.NINTC, S.DRAIN, S.REDISTLVG, S.REDISTSO, S.PUSHREDISTSUM, S.WSOFASTRANSLSO, S.IRRIG,
-				S.NCUTTING, S.PCUTTING, S.KCUTTING, S.ANLVG, S.ANLVD, S.ANST, S.ANRT, S.ANSO, 
-				S.APLVG, S.APLVD, S.APST, S.APRT, S.APSO, S.AKLVG, S.AKLVD, S.AKST, S.AKRT, S.AKSO, 
-				S.NMINT, S.PMINT, S.KMINT, S.NMINS, S.PMINS, S.KMINS, S.NMINF, S.PMINF, S.KMINF});			
-	} else { // full
-		out.values.insert(out.values.end(),
-				{ double(step), S.ROOTD, S.WA, S.TSUM, S.TSUMCROP, S.TSUMCROPLEAFAGE, S.DORMTSUM, 
-				S.PUSHDORMRECTSUM, S.PUSHREDISTENDTSUM, S.DORMTIME, S.WCUTTING, S.TRAIN, S.PAR, S.LAI, 
-				S.WLVD, S.WLV, S.WST, S.WSO, S.WRT, S.WLVG, S.TRAN, S.EVAP, S.PTRAN, S.PEVAP, 
-				S.RUNOFF, S.NINTC, S.DRAIN, S.REDISTLVG, S.REDISTSO, S.PUSHREDISTSUM, S.WSOFASTRANSLSO, S.IRRIG,
-				S.NCUTTING, S.PCUTTING, S.KCUTTING, S.ANLVG, S.ANLVD, S.ANST, S.ANRT, S.ANSO, 
-				S.APLVG, S.APLVD, S.APST, S.APRT, S.APSO, S.AKLVG, S.AKLVD, S.AKST, S.AKRT, S.AKSO, 
-				S.NMINT, S.PMINT, S.KMINT, S.NMINS, S.PMINS, S.KMINS, S.NMINF, S.PMINF, S.KMINF,
-
-				R.ROOTD, R.WA, R.TSUM, R.TSUMCROP, R.TSUMCROPLEAFAGE, R.DORMTSUM, 
-				R.PUSHDORMRECTSUM, R.PUSHREDISTENDTSUM, R.DORMTIME, R.WCUTTING, R.TRAIN, R.PAR, R.LAI, 
-				R.WLVD, R.WLV, R.WST, R.WSO, R.WRT, R.WLVG, R.TRAN, R.EVAP, R.PTRAN, R.PEVAP, 
-				R.RUNOFF, R.NINTC, R.DRAIN, R.REDISTLVG, R.REDISTSO, R.PUSHREDISTSUM, R.WSOFASTRANSLSO, R.IRRIG,
-				
-				R.NCUTTING, R.PCUTTING, R.KCUTTING, R.ANLVG, R.ANLVD, R.ANST, R.ANRT, R.ANSO, R.APLVG, R.APLVD, 
-				R.APST, R.APRT, R.APSO, R.AKLVG, R.AKLVD, R.AKST, R.AKRT, R.AKSO, R.NMINT, R.PMINT, R.KMINT, R.NMINS, R.PMINS, R.KMINS, R.NMINF, R.PMINF, R.KMINF});
-	}
+#define LC_UPDATE(name, npk) S.name = S.name + R.name * DELT;
+	LC_VARIABLES(LC_UPDATE)
+#undef LC_UPDATE
 }
 
 void LINcasModel::ratesNPK() {
@@ -125,7 +34,8 @@ void LINcasModel::ratesNPK() {
 	R.PAR  = crop.FPAR * A.SRAD;        // PAR MJ m-2 d-1   : PAR radiation
 	R.TRAIN = A.PREC;
     // Temperature sum after planting;
-	R.TSUM = (management.PLDATE <= A.date) ? DTEFF : 0; // Deg. C 
+	double PLANTED = calendar.fraction(A.date, DELT, LC_PLANTED); // (-) of the time step
+	R.TSUM = (PLANTED > 0) ? DTEFF * PLANTED : 0; // Deg. C 
 
 	// Determine water content of rooted soil
 	double WC = 0.001 * S.WA/S.ROOTD;	 // (-) 
@@ -174,7 +84,7 @@ void LINcasModel::ratesNPK() {
 	double TRANRF = R.PTRAN <= 0 ? 1 : R.TRAN/R.PTRAN; // (-)
 
 	// Drainage and Runoff is calculated using the drunir function.
-	drunir(); // compute R.DRAIN and R.RUNOFF  // mm d-1
+	drunir(WC, WCCR); // compute R.DRAIN, R.RUNOFF and R.IRRIG  // mm d-1
 	
 	// Rate of change of soil water amount;
 	R.WA = (A.PREC + EXPLOR + R.IRRIG) - (R.NINTC + R.RUNOFF + R.TRAN + R.EVAP + R.DRAIN);  // mm d-1;
@@ -213,7 +123,7 @@ void LINcasModel::ratesNPK() {
 	double PMAXRT = approx2(crop.PMINMAXRT[0], crop.PMINMAXRT[2], S.TSUMCROP);   // g P g-1 DM
 	double KMAXRT = approx2(crop.KMINMAXRT[0], crop.KMINMAXRT[2], S.TSUMCROP);   // g K g-1 DM
 	
-	std::vector<double> NPKICAL = npkical(NMINLV, PMINLV, KMINLV, 
+	std::array<double, 4> NPKICAL = npkical(NMINLV, PMINLV, KMINLV, 
 		NMINST, PMINST, KMINST, NMINSO, PMINSO, KMINSO, NMAXLV, PMAXLV, KMAXLV,
 		NMAXST, PMAXST, KMAXST, NMAXSO, PMAXSO, KMAXSO);
 	
@@ -254,18 +164,19 @@ void LINcasModel::ratesNPK() {
 	bool DORMANCY = (dormancy || PUSHDORMREC) && (!PUSHREDIST) && ((S.TSUMCROP - crop.TSUMSBR) >= 0);
 
 	// The temperature sums related to the dormancy and recovery periods.
-	R.DORMTSUM = DTEFF * DORMANCY - (S.DORMTSUM/control.DELT) * PUSHREDIST; // Deg. C
-	R.PUSHDORMRECTSUM = DTEFF * PUSHDORMREC - (S.PUSHDORMRECTSUM/control.DELT) * (!(PUSHDORMREC || PUSHREDIST));  // Deg. C;
+	R.DORMTSUM = DTEFF * DORMANCY - (S.DORMTSUM/DELT) * PUSHREDIST; // Deg. C
+	R.PUSHDORMRECTSUM = DTEFF * PUSHDORMREC - (S.PUSHDORMRECTSUM/DELT) * (!(PUSHDORMREC || PUSHREDIST));  // Deg. C;
 	
-	R.PUSHREDISTSUM = DTEFF * PUSHREDIST - (S.PUSHREDISTSUM/control.DELT) * PUSHREDISTEND;  // Deg. C
-	R.PUSHREDISTENDTSUM = DTEFF * PUSHREDIST - (S.PUSHREDISTENDTSUM/control.DELT) * (!PUSHREDISTEND); // Deg. C
+	R.PUSHREDISTSUM = DTEFF * PUSHREDIST - (S.PUSHREDISTSUM/DELT) * PUSHREDISTEND;  // Deg. C
+	R.PUSHREDISTENDTSUM = DTEFF * PUSHREDIST - (S.PUSHREDISTENDTSUM/DELT) * (!PUSHREDISTEND); // Deg. C
 
 	// No. of days in dormancy
 	R.DORMTIME = DORMANCY;  // d
 
 	// Dry matter redistribution after dormancy. The rate of redistribution of the storage roots dry matter to leaf dry matter. A certain fraction is lost for the conversion of storage organs dry matter to leaf dry matter.
-	R.REDISTSO = crop.RRREDISTSO * S.WSO * PUSHREDIST - (S.REDISTSO/control.DELT) * (S.DORMTSUM > 0); // g DM m-2 d-1
+	R.REDISTSO = crop.RRREDISTSO * S.WSO * PUSHREDIST - (S.REDISTSO/DELT) * (S.DORMTSUM > 0); // g DM m-2 d-1
 	R.REDISTLVG = crop.SO2LV * R.REDISTSO * (!DORMANCY);  // g DM m-2 d-1
+	if (out.events && EMERG) logEvents(DORMANCY, PUSHREDIST, TRANRF, NPKI);
  
 //---LIGHT INTERCEPTION AND GROWTH-----------------------------------------//
 	// Light interception and total crop growth rate.
@@ -278,7 +189,7 @@ void LINcasModel::ratesNPK() {
 
 //--- AGE;
 	// The calculation of the physiological leaf age.  ;
-	R.TSUMCROPLEAFAGE = DTEFF * EMERG - (S.TSUMCROPLEAFAGE/control.DELT) * PUSHREDIST;     // Deg. C
+	R.TSUMCROPLEAFAGE = DTEFF * EMERG - (S.TSUMCROPLEAFAGE/DELT) * PUSHREDIST;     // Deg. C
 
 	// Relative death rate due to aging depending on leaf age and the daily average temperature.
 	double RDRDV = (S.TSUMCROPLEAFAGE >= crop.TSUMLLIFE) ? approx(crop.RDRT, A.TAVG) : 0; // d-1
@@ -346,11 +257,12 @@ void LINcasModel::ratesNPK() {
 
 	// Stem cutting partioning at emergence. ;
 	if (EMERG && (S.WST == 0)) {
-		R.WCUTTING = S.WCUTTING *(-crop.FST_CUTT - crop.FRT_CUTT - crop.FLV_CUTT - crop.FSO_CUTT) ;
-		R.WRT = crop.WCUTTINGIP * crop.FRT_CUTT;	// g fibrous root DM m-2 d-1
-		R.WST = crop.WCUTTINGIP * crop.FST_CUTT;	// g stem DM m-2 d-1
-		R.WLVG = crop.WCUTTINGIP * crop.FLV_CUTT;     // g leaves DM m-2 d-1
-		R.WSO  = crop.WCUTTINGIP * crop.FSO_CUTT;     // g storage root DM m-2 d-1
+		// these are amounts that are allocated in one time step
+		R.WCUTTING = S.WCUTTING *(-crop.FST_CUTT - crop.FRT_CUTT - crop.FLV_CUTT - crop.FSO_CUTT) / DELT;
+		R.WRT = crop.WCUTTINGIP * crop.FRT_CUTT / DELT;	// g fibrous root DM m-2 d-1
+		R.WST = crop.WCUTTINGIP * crop.FST_CUTT / DELT;	// g stem DM m-2 d-1
+		R.WLVG = crop.WCUTTINGIP * crop.FLV_CUTT / DELT;     // g leaves DM m-2 d-1
+		R.WSO  = crop.WCUTTINGIP * crop.FSO_CUTT / DELT;     // g storage root DM m-2 d-1
 
 		//The amount of N, P, K transfered depends on max. concentrations in LV, ST, RT and SO 
 		R.NCUTTING = -(R.WLVG * NMAXLV + R.WST * NMAXST + R.WSO * NMAXSO + R.WRT * NMAXRT);
@@ -402,10 +314,10 @@ void LINcasModel::ratesNPK() {
 		GLAI =  0;     // m2 m-2 d-1
 	} else if ((S.LAI == 0) && (WC > soil.WCWP)) {
 		// Growth at day of seedling emergence
-		GLAI =  crop.LAII / control.DELT;  // m2 m-2 d-1
+		GLAI =  crop.LAII / DELT;  // m2 m-2 d-1
 	} else if ((S.TSUMCROP < crop.TSUMLA_MIN) && (S.LAI < crop.LAIEXPOEND)) {
 		 // Growth during juvenile stage
-		GLAI = ((S.LAI * (std::exp(crop.RGRL * DTEFF * control.DELT) - 1) / control.DELT) 
+		GLAI = ((S.LAI * (std::exp(crop.RGRL * DTEFF * DELT) - 1) / DELT) 
 				+ std::abs(R.WCUTTING) * FLV * SLA) * TRANRF * exp(-crop.NLAI * (1 - NPKI));  // m2 m-2 d-1
 	} else {
 		GLAI = SLA * GLV * (!DORMANCY);  // m2 m-2 d-1  
@@ -9,178 +9,846 @@ License: GNU General Public License (GNU GPL) v. 2
 //using namespace Rcpp;
 #include "R_interface_util.h"
 #include "LINTcas.h"
+#include "parallel.h"
+#include "outputfile.h"
+
+
+typedef std::shared_ptr<const LINcasWeatherData> WeatherPtr;
+
+WeatherPtr weatherFromDF(DataFrame weather) {
+	std::shared_ptr<LINcasWeatherData> wth = std::make_shared<LINcasWeatherData>();
+	wth->tmin = vectorFromDF<double>(weather, "tmin");
+	wth->tmax = vectorFromDF<double>(weather, "tmax");
+	wth->srad = vectorFromDF<double>(weather, "srad");
+	wth->prec = vectorFromDF<double>(weather, "prec");
+	wth->vapr = vectorFromDF<double>(weather, "vapr");
+	wth->wind = vectorFromDF<double>(weather, "wind");
+	wth->date = vectorFromDF<long>(weather, "date");
+	std::string msg;
+	if (!wth->check(msg)) {
+		stop(msg);
+	}
+	return wth;
+}
+
+// weather is either a data.frame or weather that was registered with .LC_weather. 
+// The external pointers of registered weather have a tag, such that other 
+// objects (models, generators, ...) are not taken for weather
+WeatherPtr getWeather(SEXP weather) {
+	if (TYPEOF(weather) == EXTPTRSXP) {
+		if ((R_ExternalPtrTag(weather) != Rf_install("LINcasWeather")) || (R_ExternalPtrAddr(weather) == nullptr)) {
+			stop("not a LINcasWeather object");
+		}
+		Rcpp::XPtr<WeatherPtr> p(weather);
+		return *p;
+	}
+	if (!Rf_inherits(weather, "data.frame")) {
+		stop("weather should be a data.frame or a LINcasWeather object");
+	}
+	return weatherFromDF(DataFrame(weather));
+}
+
+
+// [[Rcpp::export(".LC_weather")]]
+SEXP LC_weather(DataFrame weather) {
+	Rcpp::XPtr<WeatherPtr> p(new WeatherPtr(weatherFromDF(weather)), true, Rf_install("LINcasWeather"));
+	p.attr("class") = "LINcasWeather";
+	return p;
+}
+
+
+// if "required" is false, only the parameters that are in the lists are set
+// that is used to modify the parameters of a prepared model
+
+void setControl(LINcasControl &cntr, List control, bool required) {
+	if (required) {
+		cntr.outvars = "full";
+		cntr.water_limited = true;
+		cntr.nutrient_limited = true;
+	}
+	getValue(control, "startDATE", cntr.modelstart, required);
+	std::vector<std::string> outvars;
+	if (getValue(control, "outvars", outvars, false)) {
+		if (outvars.empty()) {
+			stop("outvars cannot be empty");
+		}
+		if ((outvars.size() == 1) && ((outvars[0] == "batch") || (outvars[0] == "states") || (outvars[0] == "full") || (outvars[0] == "events"))) {
+			cntr.outvars = outvars[0];
+		} else {
+			cntr.outvars = "custom";
+			cntr.outnames = outvars;
+		}
+	}
+	getValue(control, "timestep", cntr.DELT, false); 
+	getValue(control, "water_limited", cntr.water_limited, false); 
+	getValue(control, "nutrient_limited", cntr.nutrient_limited, false); 
+	getValue(control, "NPKmodel", cntr.NPKmodel, required);
+}
+
+
+// set the crop ('c'), soil ('s') or management ('m') parameters that are in lst. 
+// Names are matched with the parameter index from schema.h. 
+// If "required" is true, all parameters for the group must be present, 
+// and other elements in lst are ignored. Otherwise, unknown names are an error
+void setGroup(LINcasModel &m, List lst, char group, const char* groupname, bool required) {
+	const std::vector<LINcasParameter> &pars = LC_parameters();
+	std::vector<bool> found(pars.size(), false);
+	if (lst.size() > 0) {
+		if (Rf_isNull(lst.names())) {
+			stop("the " + std::string(groupname) + " parameters must be named");
+		}
+		std::vector<std::string> nms = Rcpp::as<std::vector<std::string>>(lst.names());
+		for (int i=0; i<lst.size(); i++) {
+			const std::string &name = nms[i];
+			int k = LC_parameter_index(name.c_str());
+			if ((k < 0) || (pars[k].group != group)) {
+				if (!required) {
+					stop("'" + name + "' is not a " + groupname + " parameter");
+				}
+				continue;
+			}
+			if (found[k]) continue; // first one is used
+			found[k] = true;
+			const LINcasParameter &p = pars[k];
+			if (p.date == &LINcasManagement::HVDATE) {
+				// there can be multiple harvest dates
+				m.management.setHarvest(Rcpp::as<std::vector<double>>(lst[i]));
+			} else if (p.ncol == 0) {
+				p.set(m, Rcpp::as<double>(lst[i]));
+			} else {
+				p.table(m) = TableFromMatrix(lst[i], p.ncol);
+			}
+		}
+	}
+	if (required) {
+		for (size_t k=0; k<pars.size(); k++) {
+			if ((pars[k].group == group) && (!found[k]) && (!pars[k].optional) && (!pars[k].npk || m.control.NPKmodel)) {
+				stop("parameter '" +  pars[k].name + "' not found");
+			}
+		}
+	}
+}
+
+void setParameters(LINcasModel &m, List crop, List soil, List management, List control, bool required) {
+	setControl(m.control, control, required);
+	// FERTAB is in days after planting
+	setGroup(m, management, 'm', "management", required);
+	setGroup(m, crop, 'c', "crop", required);
+	setGroup(m, soil, 's', "soil", required);
+}
+
+
+Rcpp::List modelOutput(const LINcasOutput &out, const std::vector<std::string> &messages, long modelstart) {
+	for (size_t i = 0; i < messages.size(); i++) {
+		Rcout << messages[i] << std::endl;
+	}
+	return Rcpp::List::create(out.values, out.names, modelstart);
+}
+
+Rcpp::List modelOutput(LINcasModel &m) {
+	return modelOutput(m.out, m.messages, m.control.modelstart);
+}
 
 
 // [[Rcpp::export(".LC")]]
-Rcpp::List LC(List crop, DataFrame weather, List soil, List management, List control) {
-
-	LINcasControl cntr;
-	LINcasManagement mgm;
-	LINcasCropParameters crp;
-	LINcasSoilParameters sol;
-	LINcasWeather wth;
-
-// control
-	cntr.modelstart = valueFromList<long>(control, "startDATE");
-	cntr.outvars = valueFromListDefault<std::string>(control, "outvars", "full");
-	cntr.water_limited = valueFromListDefault<bool>(control, "water_limited", true); 
-	cntr.nutrient_limited = valueFromListDefault<bool>(control, "nutrient_limited", true); 
-	cntr.NPKmodel = valueFromList<bool>(control, "NPKmodel");
-
-// management
-	mgm.PLDATE = valueFromList<long>(management, "PLDATE");
-	mgm.HVDATE = valueFromList<long>(management, "HVDATE");
-	if (cntr.NPKmodel) {
-		mgm.FERTAB = TableFromList2(management, "FERTAB", 4);
-		// DAP to date
-		for (size_t j=0; j<mgm.FERTAB[0].size(); j++) {
-			mgm.FERTAB[0][j] = mgm.FERTAB[0][j] + mgm.PLDATE;
-		}
-	}
-	
-// crop
-	crp.TWCSD = valueFromList<double>(crop, "TWCSD");
-	crp.FRACRNINTC = valueFromList<double>(crop, "FRACRNINTC");
-	crp.RECOV = valueFromList<double>(crop, "RECOV");
-	crp.TRANCO = valueFromList<double>(crop, "TRANCO");
-	crp.WCUTTINGUNIT = valueFromList<double>(crop, "WCUTTINGUNIT");
-	crp.NCUTTINGS = valueFromList<double>(crop, "NCUTTINGS");
-	crp.WCUTTINGIP = valueFromList<double>(crop, "WCUTTINGIP");
-	crp.ROOTDI = valueFromList<double>(crop, "ROOTDI");
-	crp.SLAI = valueFromList<double>(crop, "SLAI");
-	crp.WLVI = valueFromList<double>(crop, "WLVI");
-	crp.LAII = valueFromList<double>(crop, "LAII");
-	crp.WCUTTINGMINPRO = valueFromList<double>(crop, "WCUTTINGMINPRO");
-	crp.FST_CUTT = valueFromList<double>(crop, "FST_CUTT");
-	crp.FRT_CUTT = valueFromList<double>(crop, "FRT_CUTT");
-	crp.FLV_CUTT = valueFromList<double>(crop, "FLV_CUTT");
-	crp.FSO_CUTT = valueFromList<double>(crop, "FSO_CUTT");
-	crp.RDRWCUTTING = valueFromList<double>(crop, "RDRWCUTTING");
-	crp.FPAR = valueFromList<double>(crop, "FPAR");
-	crp.K_EXT = valueFromList<double>(crop, "K_EXT");
-	crp.LUE_OPT = valueFromList<double>(crop, "LUE_OPT");
-	crp.RRDMAX = valueFromList<double>(crop, "RRDMAX");
-	crp.RDRB = valueFromList<double>(crop, "RDRB");
-	crp.LAICR = valueFromList<double>(crop, "LAICR");
-	crp.RDRSHM = valueFromList<double>(crop, "RDRSHM");
-	crp.FRACTLLFENHSH = valueFromList<double>(crop, "FRACTLLFENHSH");
-	crp.FASTRANSLSO = valueFromList<double>(crop, "FASTRANSLSO");
-	crp.SLA_MAX = valueFromList<double>(crop, "SLA_MAX");
-	crp.RGRL = valueFromList<double>(crop, "RGRL");
-	crp.LAIEXPOEND = valueFromList<double>(crop, "LAIEXPOEND");
-	crp.TBASE = valueFromList<double>(crop, "TBASE");
-	crp.OPTEMERGTSUM = valueFromList<double>(crop, "OPTEMERGTSUM");
-	crp.TSUMLA_MIN = valueFromList<double>(crop, "TSUMLA_MIN");
-	crp.TSUMSBR = valueFromList<double>(crop, "TSUMSBR");
-	crp.TSUMLLIFE = valueFromList<double>(crop, "TSUMLLIFE");
-	crp.TSUMREDISTMAX = valueFromList<double>(crop, "TSUMREDISTMAX");
-	crp.FINTSUM = valueFromList<double>(crop, "FINTSUM");
-	crp.LAI_MIN = valueFromList<double>(crop, "LAI_MIN");
-	crp.WSOREDISTFRACMAX = valueFromList<double>(crop, "WSOREDISTFRACMAX");
-	crp.WLVGNEWN = valueFromList<double>(crop, "WLVGNEWN");
-	crp.SO2LV = valueFromList<double>(crop, "SO2LV");
-	crp.RRREDISTSO = valueFromList<double>(crop, "RRREDISTSO");
-	crp.DELREDIST = valueFromList<double>(crop, "DELREDIST");
-	crp.FRACSLATB = TableFromList2(crop, "FRACSLATB");
-	crp.RDRT = TableFromList2(crop, "RDRT");
-	crp.TTB = TableFromList2(crop, "TTB");
-	crp.FLVTB = TableFromList2(crop, "FLVTB");
-	crp.FSTTB = TableFromList2(crop, "FSTTB");
-	crp.FSOTB = TableFromList2(crop, "FSOTB");
-	crp.FRTTB = TableFromList2(crop, "FRTTB");
-	crp.SLAII = valueFromList<double>(crop, "SLAII");
-
-	if (cntr.NPKmodel) {
-		crp.NLAI = valueFromList<double>(crop, "NLAI");
-		crp.RDRNS = valueFromList<double>(crop, "RDRNS");
-		crp.K_MAX = valueFromList<double>(crop, "K_MAX");
-		crp.K_NPK_NI = valueFromList<double>(crop, "K_NPK_NI");
-		crp.TSUM_NPKI = valueFromList<double>(crop, "TSUM_NPKI");
-		crp.K_WATER = valueFromList<double>(crop, "K_WATER");
-		crp.SLOPE_NEQ_SOILSUPPLY_NEQ_PLANTUPTAKE = valueFromList<double>(crop, "SLOPE_NEQ_SOILSUPPLY_NEQ_PLANTUPTAKE");
-		crp.FR_MAX = valueFromList<double>(crop, "FR_MAX");
-		crp.N_RECOV = valueFromList<double>(crop, "N_RECOV");
-		crp.P_RECOV = valueFromList<double>(crop, "P_RECOV");
-		crp.K_RECOV = valueFromList<double>(crop, "K_RECOV");
-		crp.NFLVD = valueFromList<double>(crop, "NFLVD");
-		crp.PFLVD = valueFromList<double>(crop, "PFLVD");
-		crp.KFLVD = valueFromList<double>(crop, "KFLVD");
-		crp.TCNPKT = valueFromList<double>(crop, "TCNPKT");
-		crp.RTNMINF = valueFromList<double>(crop, "RTNMINF");
-		crp.RTPMINF = valueFromList<double>(crop, "RTPMINF");
-		crp.RTKMINF = valueFromList<double>(crop, "RTKMINF");
-		crp.NMINMAXLV = TableFromList2(crop, "NMINMAXLV", 3);
-		crp.PMINMAXLV = TableFromList2(crop, "PMINMAXLV", 3);
-		crp.KMINMAXLV = TableFromList2(crop, "KMINMAXLV", 3);
-		crp.NMINMAXST = TableFromList2(crop, "NMINMAXST", 3);
-		crp.PMINMAXST = TableFromList2(crop, "PMINMAXST", 3);
-		crp.KMINMAXST = TableFromList2(crop, "KMINMAXST", 3);
-		crp.NMINMAXSO = TableFromList2(crop, "NMINMAXSO", 3);
-		crp.PMINMAXSO = TableFromList2(crop, "PMINMAXSO", 3);
-		crp.KMINMAXSO = TableFromList2(crop, "KMINMAXSO", 3);
-		crp.NMINMAXRT = TableFromList2(crop, "NMINMAXRT", 3);
-		crp.PMINMAXRT = TableFromList2(crop, "PMINMAXRT", 3);
-		crp.KMINMAXRT = TableFromList2(crop, "KMINMAXRT", 3);
-	}
-	
-//soil 
-	sol.ROOTDM = valueFromList<double>(soil, "ROOTDM"); 
-	sol.WCAD = valueFromList<double>(soil, "WCAD");
-	sol.WCWP = valueFromList<double>(soil, "WCWP");
-	sol.WCFC = valueFromList<double>(soil, "WCFC");
-	sol.WCWET = valueFromList<double>(soil, "WCWET");
-	sol.WCST = valueFromList<double>(soil, "WCST");
-	sol.DRATE = valueFromList<double>(soil, "DRATE");
-	if (cntr.NPKmodel) {
-		sol.NMINI = valueFromList<double>(soil, "NMINI");
-		sol.PMINI = valueFromList<double>(soil, "PMINI");
-		sol.KMINI = valueFromList<double>(soil, "KMINI");
-	}
-	
-// weather
-	wth.tmin = vectorFromDF<double>(weather, "tmin");
-	wth.tmax = vectorFromDF<double>(weather, "tmax");
-	wth.srad = vectorFromDF<double>(weather, "srad");
-	wth.prec = vectorFromDF<double>(weather, "prec");
-	wth.vapr = vectorFromDF<double>(weather, "vapr");
-	wth.wind = vectorFromDF<double>(weather, "wind");
-	wth.date = vectorFromDF<long>(weather, "date");
-	
+Rcpp::List LC(List crop, SEXP weather, List soil, List management, List control) {
 	LINcasModel m;
-	m.crop = crp;
-	m.soil = sol;
-	m.control = cntr;
-	m.management = mgm;
-	m.weather = wth;
+	setParameters(m, crop, soil, management, control, true);
+	m.weather.set(getWeather(weather));
 	m.run();
+	return modelOutput(m);
+}
+
+
+// prepared models. Parameters are parsed once and can then be modified and run many times 
+
+SEXP modelPointer(LINcasModel *m) {
+	Rcpp::XPtr<LINcasModel> p(m, true);
+	p.attr("class") = "LINcasModel";
+	return p;
+}
+
+// [[Rcpp::export(".LC_prepare")]]
+SEXP LC_prepare(List crop, List soil, List management, List control) {
+	std::unique_ptr<LINcasModel> m(new LINcasModel);
+	setParameters(*m, crop, soil, management, control, true);
+	return modelPointer(m.release());
+}
+
+// [[Rcpp::export(".LC_set")]]
+void LC_set(SEXP model, List crop, List soil, List management, List control, SEXP weather) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	setParameters(*m, crop, soil, management, control, false);
+	if (!Rf_isNull(weather)) {
+		m->weather.set(getWeather(weather));
+	}
+}
+
+// [[Rcpp::export(".LC_run")]]
+Rcpp::List LC_run(SEXP model) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	if (m->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	m->run();
+	return modelOutput(*m);
+}
+
 
-	if (m.fatalError) {
-		for (size_t i = 0; i < m.messages.size(); i++) {
-			Rcout << m.messages[i] << std::endl;
+// run a prepared model for each row of a data.frame with parameter values.
+// The parameters of the prepared model are not changed. Each thread has its 
+// own model that is reused for all its jobs
+// the parameter index and the values of each column of a data.frame of parameters
+static void sweepParameters(DataFrame parameters, std::vector<int> &index, std::vector<std::vector<double>> &cols) {
+	const std::vector<LINcasParameter> &pars = LC_parameters();
+	std::vector<std::string> nms = Rcpp::as<std::vector<std::string>>(parameters.names());
+	for (size_t j=0; j<nms.size(); j++) {
+		int k = LC_parameter_index(nms[j].c_str());
+		if (k < 0) {
+			stop("'" + nms[j] + "' is not a parameter");
 		}
+		if (pars[k].ncol > 0) {
+			stop("'" + nms[j] + "' is a table. Tables cannot be used in a sweep");
+		}
+		index.push_back(k);
+		cols.push_back(Rcpp::as<std::vector<double>>(parameters[j]));
 	}
+}
 
-	Rcpp::List out = Rcpp::List::create(m.out.values, m.out.names);
+// run the model for each row of parameters, and call done(row, model) after each run
+template <class F>
+static void sweepRuns(const LINcasModel &base, DataFrame parameters, int threads, F done) {
+	std::vector<int> index;
+	std::vector<std::vector<double>> cols;
+	sweepParameters(parameters, index, cols);
 
-/*
-	size_t nc = m.out.names.size();
-	size_t nr = m.out.values.size() / nc;
-	NumericMatrix mat(nr, nc);
-	
-	CharacterVector cnames = wrap(m.out.names);
-	colnames(mat) = cnames;
+	size_t n = parameters.nrow();
+	size_t nthreads = std::max(1, threads);
+	std::vector<LINcasModel> pool(nthreads);
+	std::vector<LINcasOverlay> overlays(nthreads);
+	for (LINcasOverlay &ov : overlays) {
+		for (int k : index) ov.values.push_back({k, 0});
+	}
 
-	size_t k=0;
-	for (size_t i = 0; i < nr; i++) {
-		for (size_t j = 0; j < nc; j++) {
-			mat(i, j) = m.out.values[k];
-			k++;
+	LC_parallel(n, nthreads, [&](size_t i, size_t t) {
+		LINcasModel &m = pool[t];
+		LINcasOverlay &ov = overlays[t];
+		for (size_t j=0; j<cols.size(); j++) {
+			ov.values[j].second = cols[j][i];
 		}
+		ov.apply(base, m);
+		m.run();
+		done(i, m);
+	});
+}
+
+// [[Rcpp::export(".LC_sweep")]]
+Rcpp::List LC_sweep(SEXP model, DataFrame parameters, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
 	}
+	size_t n = parameters.nrow();
+	std::vector<LINcasOutput> out(n);
+	std::vector<std::vector<std::string>> messages(n);
+	sweepRuns(*base, parameters, threads, [&](size_t i, const LINcasModel &m) {
+		out[i].names = m.out.names;
+		out[i].values = m.out.values;
+		messages[i] = m.messages;
+	});
+
+	Rcpp::List r(n);
+	for (size_t i=0; i<n; i++) {
+		r[i] = modelOutput(out[i], messages[i], base->control.modelstart);
+	}
+	return r;
+}
+
+
+// a sweep of which the output of each run (job) is written to a file, and not
+// kept in memory. The date of each row of the output is added as a column
+// [[Rcpp::export(".LC_sweep_file")]]
+void LC_sweep_file(SEXP model, DataFrame parameters, std::string filename, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	LINcasOutputFile file;
+	std::string msg;
+	if (!file.create(filename, msg)) {
+		stop(msg);
+	}
+	size_t n = parameters.nrow();
+	std::vector<std::vector<std::string>> messages(n);
+	std::vector<std::string> errors(n);
+	sweepRuns(*base, parameters, threads, [&](size_t i, const LINcasModel &m) {
+		messages[i] = m.messages;
+		const std::vector<std::string> &nms = m.out.names;
+		size_t nc = nms.size();
+		size_t nr = (nc == 0) ? 0 : m.out.values.size() / nc;
+		std::vector<double> date(nr);
+		size_t k = std::find(nms.begin(), nms.end(), "harvest") - nms.begin();
+		if (k == nc) {
+			k = std::find(nms.begin(), nms.end(), "step") - nms.begin();
+		}
+		for (size_t r=0; r<nr; r++) {
+			date[r] = (k == nc) ? NAN : (nms[k] == "harvest") ? m.out.values[r * nc + k] : (m.control.modelstart - 1 + m.out.values[r * nc + k]);
+		}
+		if (!(file.write(i + 1, "date", date.data(), nr, 1, errors[i]) && file.write(i + 1, m.out, errors[i]))) {
+			messages[i].push_back(errors[i]);
+		}
+	});
+	bool ok = file.close(msg);
+	for (size_t i=0; i<n; i++) {
+		for (const std::string &s : messages[i]) {
+			Rcout << s << std::endl;
+		}
+	}
+	for (size_t i=0; i<n; i++) {
+		if (!errors[i].empty()) stop(errors[i]);
+	}
+	if (!ok) {
+		stop(msg);
+	}
+}
+
+
+// [[Rcpp::export(".LC_output_open")]]
+SEXP LC_output_open(std::string filename) {
+	LINcasOutputFile* x = new LINcasOutputFile;
+	std::string msg;
+	if (!x->open(filename, msg)) {
+		delete x;
+		stop(msg);
+	}
+	Rcpp::XPtr<LINcasOutputFile> p(x, true);
+	p.attr("class") = "LINcasOutputFile";
+	return p;
+}
+
+// the jobs (if "jobs" is true; that requires a pass over the index) and the 
+// columns in an output file
+// [[Rcpp::export(".LC_output_info")]]
+Rcpp::List LC_output_info(SEXP file, bool jobs) {
+	Rcpp::XPtr<LINcasOutputFile> x(file);
+	std::vector<size_t> j;
+	if (jobs) j = x->jobs();
+	return Rcpp::List::create(std::vector<double>(j.begin(), j.end()), x->columns());
+}
+
+// read some columns of some jobs. Returns the job of each row, and the values
+// of each column. Columns that a job does not have are NA
+// [[Rcpp::export(".LC_output_read")]]
+Rcpp::List LC_output_read(SEXP file, std::vector<double> jobs, std::vector<std::string> columns) {
+	Rcpp::XPtr<LINcasOutputFile> x(file);
+	std::vector<double> job;
+	std::vector<std::vector<double>> values(columns.size());
+	std::vector<double> v;
+	std::string msg;
+	for (double j : jobs) {
+		size_t nr = std::string::npos;
+		for (size_t k=0; k<columns.size(); k++) {
+			if (!x->read(size_t(j), columns[k], v, msg)) {
+				if (!msg.empty()) stop(msg);
+				continue;
+			}
+			nr = std::min(nr, v.size());
+			values[k].insert(values[k].end(), v.begin(), v.end());
+		}
+		if (nr == std::string::npos) nr = 0;
+		job.resize(job.size() + nr, j);
+		for (std::vector<double> &c : values) {
+			c.resize(job.size(), NAN);
+		}
+	}
+	Rcpp::List r(columns.size());
+	for (size_t k=0; k<columns.size(); k++) {
+		r[k] = values[k];
+	}
+	return Rcpp::List::create(job, r);
+}
+
+
+// screening of many parameter sets with coarse time steps
+// [[Rcpp::export(".LC_screen")]]
+Rcpp::List LC_screen(SEXP model, DataFrame parameters, int delt, std::vector<double> sample, double tolerance, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	std::vector<int> index;
+	std::vector<std::vector<double>> cols;
+	sweepParameters(parameters, index, cols);
+	if (cols.empty()) {
+		stop("no parameters");
+	}
+	// from R (1-based) indices
+	std::vector<size_t> s;
+	for (double i : sample) s.push_back(size_t(i) - 1);
+	LINcasOutput out;
+	std::vector<std::string> messages;
+	double calibration;
+	if (!LC_screening(*base, index, cols, std::max(1, delt), s, tolerance, std::max(1, threads), out, calibration, messages)) {
+		std::string msg = messages.empty() ? "screening failed" : messages.back();
+		stop(msg);
+	}
+	Rcpp::List r = modelOutput(out, messages, base->control.modelstart);
+	r.push_back(calibration);
+	return r;
+}
+
+
+static LINcasWeatherCube weatherCube(NumericVector weather, const std::vector<double> &dates) {
+	IntegerVector dims = weather.attr("dim");
+	if ((dims.size() != 3) || (dims[1] != int(dates.size())) || (dims[2] != 6)) {
+		stop("weather should be an array with dimensions (cells, days, 6)");
+	}
+	LINcasWeatherCube w;
+	w.values = weather.begin();
+	w.ncells = dims[0];
+	w.date = std::vector<long>(dates.begin(), dates.end());
+	return w;
+}
+
+// a model run for each cell of a grid. weather is an array (cells, days, variables)
+// [[Rcpp::export(".LC_grid")]]
+Rcpp::List LC_grid(SEXP model, NumericVector weather, std::vector<double> dates, DataFrame parameters, std::vector<int> mask, std::vector<std::string> vars, int tile, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	LINcasWeatherCube w = weatherCube(weather, dates);
+	std::vector<int> index;
+	std::vector<std::vector<double>> cols;
+	sweepParameters(parameters, index, cols);
+	std::vector<double> out;
+	std::vector<std::string> messages;
+	if (!LC_grid_run(*base, w, index, cols, mask, vars, std::max(1, tile), std::max(1, threads), out, messages)) {
+		std::string msg = messages.empty() ? "grid run failed" : messages.back();
+		stop(msg);
+	}
+	LINcasOutput r;
+	r.values = std::move(out);
+	r.names = vars;
+	return modelOutput(r, messages, base->control.modelstart);
+}
+
+
+// a model run with the weather in each file
+// [[Rcpp::export(".LC_batch")]]
+Rcpp::List LC_batch(SEXP model, std::vector<std::string> files, int threads, int prefetch) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	LINcasOutput out;
+	std::vector<std::string> messages;
+	if (!LC_batch_run(*base, files, std::max(1, threads), std::max(1, prefetch), out, messages)) {
+		std::string msg = messages.empty() ? "batch run failed" : messages.back();
+		stop(msg);
+	}
+	return modelOutput(out, messages, base->control.modelstart);
+}
 
-	return(mat);
-*/
 
+// a grid run of which the output is aggregated by zone
+// [[Rcpp::export(".LC_grid_zonal")]]
+Rcpp::List LC_grid_zonal(SEXP model, NumericVector weather, std::vector<double> dates, DataFrame parameters, std::vector<int> mask, std::vector<std::string> vars, std::vector<int> zones, std::vector<double> weights, std::vector<double> probs, int tile, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	LINcasWeatherCube w = weatherCube(weather, dates);
+	std::vector<int> index;
+	std::vector<std::vector<double>> cols;
+	sweepParameters(parameters, index, cols);
+	LINcasZones z;
+	z.id = zones;
+	z.weight = weights;
+	z.probs = probs;
+	LINcasOutput out;
+	std::vector<std::string> messages;
+	if (!LC_grid_zonal(*base, w, index, cols, mask, vars, z, std::max(1, tile), std::max(1, threads), out, messages)) {
+		std::string msg = messages.empty() ? "grid run failed" : messages.back();
+		stop(msg);
+	}
+	return modelOutput(out, messages, base->control.modelstart);
+}
+
+
+// planting date sweep. The states at harvest for each planting date 
+// [[Rcpp::export(".LC_planting")]]
+Rcpp::List LC_planting(SEXP model, std::vector<double> dates, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	std::vector<long> d(dates.begin(), dates.end());
+	LINcasOutput out;
+	std::vector<std::string> messages;
+	if (!LC_planting_sweep(*base, d, std::max(1, threads), out, messages)) {
+		std::string msg = messages.empty() ? "planting date sweep failed" : messages.back();
+		stop(msg);
+	}
+	return modelOutput(out, messages, base->control.modelstart);
+}
+
+
+// in-season forecast with an ensemble of weather data for the rest of the season
+// [[Rcpp::export(".LC_ensemble")]]
+Rcpp::List LC_ensemble(SEXP model, double today, List members, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	std::vector<WeatherPtr> w;
+	w.reserve(members.size());
+	for (int i=0; i<members.size(); i++) {
+		w.push_back(getWeather(members[i]));
+	}
+	LINcasOutput out;
+	std::vector<std::string> messages;
+	if (!LC_ensemble_forecast(*base, long(today), w, std::max(1, threads), out, messages)) {
+		std::string msg = messages.empty() ? "ensemble forecast failed" : messages.back();
+		stop(msg);
+	}
+	return modelOutput(out, messages, base->control.modelstart);
+}
+
+
+// fertilizer schedules (FERTAB tables) for an NPK model
+// [[Rcpp::export(".LC_fertilizer")]]
+Rcpp::List LC_fertilizer(SEXP model, List schedules, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	std::vector<LINcasTable> f;
+	f.reserve(schedules.size());
+	for (int i=0; i<schedules.size(); i++) {
+		f.push_back(TableFromMatrix(schedules[i], 4));
+	}
+	LINcasOutput out;
+	std::vector<std::string> messages;
+	if (!LC_fertilizer_sweep(*base, f, std::max(1, threads), out, messages)) {
+		std::string msg = messages.empty() ? "fertilizer sweep failed" : messages.back();
+		stop(msg);
+	}
+	return modelOutput(out, messages, base->control.modelstart);
+}
+
+
+// deficit irrigation strategies
+// [[Rcpp::export(".LC_irrigation")]]
+Rcpp::List LC_irrigation(SEXP model, std::vector<double> frac, std::vector<double> amount, std::vector<double> max, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	std::vector<std::array<double, 3>> s(frac.size());
+	for (size_t i=0; i<s.size(); i++) {
+		s[i] = {frac[i], amount[i], max[i]};
+	}
+	LINcasOutput out;
+	std::vector<std::string> messages;
+	if (!LC_irrigation_sweep(*base, s, std::max(1, threads), out, messages)) {
+		std::string msg = messages.empty() ? "irrigation sweep failed" : messages.back();
+		stop(msg);
+	}
+	return modelOutput(out, messages, base->control.modelstart);
+}
+
+
+// a sequence of seasons with the soil water and nutrients carried over
+// [[Rcpp::export(".LC_rotation")]]
+Rcpp::List LC_rotation(SEXP model, std::vector<double> plant, std::vector<double> harvest, std::vector<std::string> vars, std::vector<std::string> funs) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	std::vector<long> p(plant.begin(), plant.end());
+	std::vector<long> h(harvest.begin(), harvest.end());
+	LINcasOutput out;
+	std::vector<std::string> messages;
+	if (!LC_rotation(*base, p, h, vars, funs, out, messages)) {
+		std::string msg = messages.empty() ? "rotation failed" : messages.back();
+		stop(msg);
+	}
+	return modelOutput(out, messages, base->control.modelstart);
+}
+
+
+// yield gap analysis: potential and water (and nutrient) limited yield in one run
+// [[Rcpp::export(".LC_yieldgap")]]
+Rcpp::List LC_yieldgap(SEXP model) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	LINcasOutput out;
+	std::vector<std::string> messages;
+	if (!LC_yield_gap(*base, out, messages)) {
+		std::string msg = messages.empty() ? "yield gap analysis failed" : messages.back();
+		stop(msg);
+	}
+	return modelOutput(out, messages, base->control.modelstart);
+}
+
+
+// climate change scenarios
+
+typedef std::shared_ptr<const LINcasWeatherTransform> TransformPtr;
+
+// the values for each month (one value is used for all months)
+static void monthly(List x, const char* name, double* v) {
+	std::vector<double> d = Rcpp::as<std::vector<double>>(x[name]);
+	if ((d.size() != 1) && (d.size() != 12)) {
+		stop("'" + std::string(name) + "' must have 1 or 12 values");
+	}
+	for (int m=0; m<12; m++) {
+		v[m] = d[d.size() == 1 ? 0 : m];
+	}
+}
+
+// [[Rcpp::export(".LC_scenario")]]
+SEXP LC_scenario(List x) {
+	std::shared_ptr<LINcasWeatherTransform> t = std::make_shared<LINcasWeatherTransform>();
+	monthly(x, "tmin", t->dtmin);
+	monthly(x, "tmax", t->dtmax);
+	monthly(x, "srad", t->fsrad);
+	monthly(x, "prec", t->fprec);
+	monthly(x, "wind", t->fwind);
+	monthly(x, "vapr", t->fvapr);
+	t->rh = Rcpp::as<bool>(x["rh"]);
+	Rcpp::XPtr<TransformPtr> p(new TransformPtr(t), true);
+	p.attr("class") = "LINcasScenario";
+	return p;
+}
+
+// set (or remove, if NULL) the scenario of a model
+// [[Rcpp::export(".LC_set_scenario")]]
+void LC_set_scenario(SEXP model, SEXP scenario) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	if (Rf_isNull(scenario)) {
+		m->weather.transform = nullptr;
+	} else {
+		Rcpp::XPtr<TransformPtr> t(scenario);
+		m->weather.transform = *t;
+	}
+}
+
+// run a prepared model for each scenario. The scenarios share the weather data
+// [[Rcpp::export(".LC_scenarios")]]
+Rcpp::List LC_scenarios(SEXP model, List scenarios, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	size_t n = scenarios.size();
+	std::vector<TransformPtr> t(n);
+	for (size_t i=0; i<n; i++) {
+		Rcpp::XPtr<TransformPtr> p(scenarios[i]);
+		t[i] = *p;
+	}
+	size_t nthreads = std::max(1, threads);
+	std::vector<LINcasModel> pool(nthreads);
+	std::vector<LINcasOutput> out(n);
+	std::vector<std::vector<std::string>> messages(n);
+	LINcasOverlay ov;
+	LC_parallel(n, nthreads, [&](size_t i, size_t j) {
+		LINcasModel &m = pool[j];
+		ov.apply(*base, m);
+		m.weather.transform = t[i];
+		m.run();
+		out[i].names = m.out.names;
+		out[i].values = m.out.values;
+		messages[i] = m.messages;
+	});
+
+	Rcpp::List r(n);
+	for (size_t i=0; i<n; i++) {
+		r[i] = modelOutput(out[i], messages[i], base->control.modelstart);
+	}
+	return r;
+}
+
+
+// stochastic weather
+
+typedef std::shared_ptr<const LINcasWeatherGenerator> GeneratorPtr;
+
+// [[Rcpp::export(".LC_generator")]]
+SEXP LC_generator(SEXP weather) {
+	WeatherPtr w = getWeather(weather);
+	std::shared_ptr<LINcasWeatherGenerator> g = std::make_shared<LINcasWeatherGenerator>();
+	std::string msg;
+	if (!g->fit(*w, msg)) {
+		stop(msg);
+	}
+	Rcpp::XPtr<GeneratorPtr> p(new GeneratorPtr(g), true);
+	p.attr("class") = "LINcasGenerator";
+	return p;
+}
+
+// [[Rcpp::export(".LC_generate")]]
+Rcpp::List LC_generate(SEXP generator, std::vector<double> dates, double seed) {
+	Rcpp::XPtr<GeneratorPtr> g(generator);
+	size_t n = dates.size();
+	std::vector<double> srad(n), tmin(n), tmax(n), prec(n), wind(n), vapr(n);
+	LINcasGeneratorState state;
+	state.seed(uint64_t(seed));
+	LINcasDay d;
+	for (size_t i=0; i<n; i++) {
+		state.next(**g, long(dates[i]), d);
+		srad[i] = d.srad;
+		tmin[i] = d.tmin;
+		tmax[i] = d.tmax;
+		prec[i] = d.prec;
+		wind[i] = d.wind;
+		vapr[i] = d.vapr;
+	}
+	return Rcpp::List::create(Named("date")=dates, Named("srad")=srad, Named("tmin")=tmin, Named("tmax")=tmax, Named("prec")=prec, Named("wind")=wind, Named("vapr")=vapr);
+}
+
+// [[Rcpp::export(".LC_stochastic")]]
+Rcpp::List LC_stochastic(SEXP model, SEXP generator, int n, double seed, int threads) {
+	Rcpp::XPtr<LINcasModel> base(model);
+	if (base->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	Rcpp::XPtr<GeneratorPtr> g(generator);
+	LINcasOutput out;
+	std::vector<std::string> messages;
+	if (!LC_stochastic_runs(*base, *g, std::max(0, n), uint64_t(seed), std::max(1, threads), out, messages)) {
+		std::string msg = messages.empty() ? "stochastic runs failed" : messages.back();
+		stop(msg);
+	}
+	return modelOutput(out, messages, base->control.modelstart);
+}
+
+
+// step-wise simulation, snapshots and forks of prepared models
+
+// [[Rcpp::export(".LC_start")]]
+void LC_start(SEXP model) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	if (m->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	if (m->multipleHarvests() && m->control.NPKmodel) {
+		stop("cannot start an NPK model with multiple harvest dates");
+	}
+	m->reset();
+	if (!m->start()) {
+		stop(m->messages.empty() ? "cannot start the model" : m->messages.back());
+	}
+}
+
+// simulate until the start of "date". Returns false if the simulation has ended
+// [[Rcpp::export(".LC_advance")]]
+bool LC_advance(SEXP model, double date) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	while ((!m->ended) && (m->time < m->weather.date.size()) && (m->weather.date[m->time] < date)) {
+		m->step_day(long(date) - 1);
+	}
+	if ((!m->ended) && (m->time >= m->weather.date.size())) {
+		stop("there is no weather data after " + LC_date_string(m->weather.date[m->time - 1]));
+	}
+	return !m->ended;
+}
+
+// [[Rcpp::export(".LC_finish")]]
+Rcpp::List LC_finish(SEXP model) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	while (m->step_day()) {}
+	if (!m->fatalError) {
+		m->finish();
+	}
+	return modelOutput(*m);
+}
+
+// [[Rcpp::export(".LC_fork")]]
+Rcpp::List LC_fork(SEXP model, int n) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	std::vector<LINcasModel> f = m->fork(std::max(0, n));
+	Rcpp::List out(f.size());
+	for (size_t i=0; i<f.size(); i++) {
+		out[i] = modelPointer(new LINcasModel(std::move(f[i])));
+	}
 	return out;
 }
 
+// [[Rcpp::export(".LC_snapshot")]]
+SEXP LC_snapshot(SEXP model) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	Rcpp::XPtr<LINcasSnapshot> p(new LINcasSnapshot(m->snapshot()), true);
+	p.attr("class") = "LINcasSnapshot";
+	return p;
+}
+
+// [[Rcpp::export(".LC_restore")]]
+void LC_restore(SEXP model, SEXP snapshot) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	Rcpp::XPtr<LINcasSnapshot> x(snapshot);
+	m->restore(*x);
+}
+
+// [[Rcpp::export(".LC_checkpoint")]]
+Rcpp::RawVector LC_checkpoint(SEXP model) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	std::vector<unsigned char> x = m->checkpoint();
+	return Rcpp::RawVector(x.begin(), x.end());
+}
+
+// [[Rcpp::export(".LC_resume")]]
+void LC_resume(SEXP model, Rcpp::RawVector checkpoint) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	if (m->weather.data == nullptr) {
+		stop("no weather data");
+	}
+	std::vector<unsigned char> x(checkpoint.begin(), checkpoint.end());
+	std::string msg;
+	if (!m->resume(x, msg)) {
+		stop(msg);
+	}
+}
+
+
+// nowcasting: incremental updates with new weather
+
+// [[Rcpp::export(".LC_nowcast")]]
+SEXP LC_nowcast(SEXP model, int interval) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	std::unique_ptr<LINcasNowcast> x(new LINcasNowcast);
+	x->model = *m;
+	x->interval = std::max(1, interval);
+	Rcpp::XPtr<LINcasNowcast> p(x.release(), true);
+	p.attr("class") = "LINcasNowcast";
+	return p;
+}
+
+// update each nowcast with its weather, up to "today" (or the end of the weather if NA)
+// [[Rcpp::export(".LC_update")]]
+Rcpp::List LC_update(List nowcasts, List weather, double today, int threads) {
+	size_t n = nowcasts.size();
+	std::vector<LINcasNowcast*> x(n);
+	std::vector<WeatherPtr> w(n);
+	std::vector<long> days(n);
+	for (size_t i=0; i<n; i++) {
+		Rcpp::XPtr<LINcasNowcast> p(nowcasts[i]);
+		x[i] = p.get();
+		w[i] = getWeather(weather[i]);
+		days[i] = ISNAN(today) ? w[i]->date.back() : long(today);
+	}
+	// each nowcast is updated by one thread
+	std::vector<LINcasNowcast*> sorted = x;
+	std::sort(sorted.begin(), sorted.end());
+	if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+		stop("a nowcast can only be updated once in a call");
+	}
+	std::vector<std::string> msg(n);
+	std::vector<int> ok(n);
+	LC_parallel(n, std::max(1, threads), [&](size_t i, size_t t) {
+		ok[i] = x[i]->update(w[i], days[i], msg[i]);
+	});
+
+	Rcpp::List r(n);
+	for (size_t i=0; i<n; i++) {
+		if (!ok[i]) {
+			stop(msg[i]);
+		}
+		r[i] = Rcpp::List::create(x[i]->model.out.values, x[i]->model.out.names, x[i]->model.control.modelstart, double(x[i]->simulated));
+	}
+	return r;
+}
@@ -14,27 +14,6 @@ using namespace Rcpp;
 #include <vector>
 #include <string>
 
-template <class T>
-T valueFromList(List lst, const char*s) {
-	if (!lst.containsElementNamed(s) ) {
-		std::string ss = "parameter '" +  std::string(s) + "' not found";
-		stop(ss);
-	}
-	T v = lst[s];
-	return(v);
-}
-
-
-template <class T>
-T valueFromListDefault(List lst, const char*s, T def) {
-	if (!lst.containsElementNamed(s) ) {
-		return def;
-	}
-	T v = lst[s];
-	return(v);
-}
-
-
 template <class T>
 std::vector<T> vectorFromList(List lst, const char*s) {
 	if (!lst.containsElementNamed(s) ) {
@@ -74,14 +53,7 @@ std::vector<double> TableFromList(List lst, const char* s){
 }
 
 
-std::vector<std::vector<double>> TableFromList2(List lst, const char* s, size_t n=2){
-
-	if(! lst.containsElementNamed(s)){
-		std::string ss = "parameter '" +  std::string(s) + "' not found";
-		stop(ss);
-	}
-
-	NumericMatrix x = lst[s];
+inline std::vector<std::vector<double>> TableFromMatrix(NumericMatrix x, size_t n=2){
 	if (x.ncol() != (int) n){
 		std::string ss2 = "ncol != " + std::to_string(n);
 		stop(ss2);
@@ -100,5 +72,21 @@ std::vector<std::vector<double>> TableFromList2(List lst, const char* s, size_t
 	return out;
 }
 
+
+// set v if s is in lst. It is an error if s is not in lst and required is true
+template <class T>
+bool getValue(List lst, const char*s, T &v, bool required) {
+	if (!lst.containsElementNamed(s) ) {
+		if (required) {
+			std::string ss = "parameter '" +  std::string(s) + "' not found";
+			stop(ss);
+		}
+		return false;
+	}
+	T x = lst[s];
+	v = x;
+	return true;
+}
+
 #endif
 
@@ -10,14 +10,25 @@ Rcpp::Rostream<true>&  Rcpp::Rcout = Rcpp::Rcpp_cout_get();
 Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
+// LC_weather
+SEXP LC_weather(DataFrame weather);
+RcppExport SEXP _LINTULcassava_LC_weather(SEXP weatherSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< DataFrame >::type weather(weatherSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_weather(weather));
+    return rcpp_result_gen;
+END_RCPP
+}
 // LC
-Rcpp::List LC(List crop, DataFrame weather, List soil, List management, List control);
+Rcpp::List LC(List crop, SEXP weather, List soil, List management, List control);
 RcppExport SEXP _LINTULcassava_LC(SEXP cropSEXP, SEXP weatherSEXP, SEXP soilSEXP, SEXP managementSEXP, SEXP controlSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type crop(cropSEXP);
-    Rcpp::traits::input_parameter< DataFrame >::type weather(weatherSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type weather(weatherSEXP);
     Rcpp::traits::input_parameter< List >::type soil(soilSEXP);
     Rcpp::traits::input_parameter< List >::type management(managementSEXP);
     Rcpp::traits::input_parameter< List >::type control(controlSEXP);
@@ -25,11 +36,499 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// LC_prepare
+SEXP LC_prepare(List crop, List soil, List management, List control);
+RcppExport SEXP _LINTULcassava_LC_prepare(SEXP cropSEXP, SEXP soilSEXP, SEXP managementSEXP, SEXP controlSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type crop(cropSEXP);
+    Rcpp::traits::input_parameter< List >::type soil(soilSEXP);
+    Rcpp::traits::input_parameter< List >::type management(managementSEXP);
+    Rcpp::traits::input_parameter< List >::type control(controlSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_prepare(crop, soil, management, control));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_set
+void LC_set(SEXP model, List crop, List soil, List management, List control, SEXP weather);
+RcppExport SEXP _LINTULcassava_LC_set(SEXP modelSEXP, SEXP cropSEXP, SEXP soilSEXP, SEXP managementSEXP, SEXP controlSEXP, SEXP weatherSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< List >::type crop(cropSEXP);
+    Rcpp::traits::input_parameter< List >::type soil(soilSEXP);
+    Rcpp::traits::input_parameter< List >::type management(managementSEXP);
+    Rcpp::traits::input_parameter< List >::type control(controlSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type weather(weatherSEXP);
+    LC_set(model, crop, soil, management, control, weather);
+    return R_NilValue;
+END_RCPP
+}
+// LC_run
+Rcpp::List LC_run(SEXP model);
+RcppExport SEXP _LINTULcassava_LC_run(SEXP modelSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_run(model));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_sweep
+Rcpp::List LC_sweep(SEXP model, DataFrame parameters, int threads);
+RcppExport SEXP _LINTULcassava_LC_sweep(SEXP modelSEXP, SEXP parametersSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< DataFrame >::type parameters(parametersSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_sweep(model, parameters, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_sweep_file
+void LC_sweep_file(SEXP model, DataFrame parameters, std::string filename, int threads);
+RcppExport SEXP _LINTULcassava_LC_sweep_file(SEXP modelSEXP, SEXP parametersSEXP, SEXP filenameSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< DataFrame >::type parameters(parametersSEXP);
+    Rcpp::traits::input_parameter< std::string >::type filename(filenameSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    LC_sweep_file(model, parameters, filename, threads);
+    return R_NilValue;
+END_RCPP
+}
+// LC_output_open
+SEXP LC_output_open(std::string filename);
+RcppExport SEXP _LINTULcassava_LC_output_open(SEXP filenameSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type filename(filenameSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_output_open(filename));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_output_info
+Rcpp::List LC_output_info(SEXP file, bool jobs);
+RcppExport SEXP _LINTULcassava_LC_output_info(SEXP fileSEXP, SEXP jobsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< bool >::type jobs(jobsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_output_info(file, jobs));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_output_read
+Rcpp::List LC_output_read(SEXP file, std::vector<double> jobs, std::vector<std::string> columns);
+RcppExport SEXP _LINTULcassava_LC_output_read(SEXP fileSEXP, SEXP jobsSEXP, SEXP columnsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type jobs(jobsSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type columns(columnsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_output_read(file, jobs, columns));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_screen
+Rcpp::List LC_screen(SEXP model, DataFrame parameters, int delt, std::vector<double> sample, double tolerance, int threads);
+RcppExport SEXP _LINTULcassava_LC_screen(SEXP modelSEXP, SEXP parametersSEXP, SEXP deltSEXP, SEXP sampleSEXP, SEXP toleranceSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< DataFrame >::type parameters(parametersSEXP);
+    Rcpp::traits::input_parameter< int >::type delt(deltSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type sample(sampleSEXP);
+    Rcpp::traits::input_parameter< double >::type tolerance(toleranceSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_screen(model, parameters, delt, sample, tolerance, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_grid
+Rcpp::List LC_grid(SEXP model, NumericVector weather, std::vector<double> dates, DataFrame parameters, std::vector<int> mask, std::vector<std::string> vars, int tile, int threads);
+RcppExport SEXP _LINTULcassava_LC_grid(SEXP modelSEXP, SEXP weatherSEXP, SEXP datesSEXP, SEXP parametersSEXP, SEXP maskSEXP, SEXP varsSEXP, SEXP tileSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type weather(weatherSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type dates(datesSEXP);
+    Rcpp::traits::input_parameter< DataFrame >::type parameters(parametersSEXP);
+    Rcpp::traits::input_parameter< std::vector<int> >::type mask(maskSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type vars(varsSEXP);
+    Rcpp::traits::input_parameter< int >::type tile(tileSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_grid(model, weather, dates, parameters, mask, vars, tile, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_batch
+Rcpp::List LC_batch(SEXP model, std::vector<std::string> files, int threads, int prefetch);
+RcppExport SEXP _LINTULcassava_LC_batch(SEXP modelSEXP, SEXP filesSEXP, SEXP threadsSEXP, SEXP prefetchSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type files(filesSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< int >::type prefetch(prefetchSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_batch(model, files, threads, prefetch));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_grid_zonal
+Rcpp::List LC_grid_zonal(SEXP model, NumericVector weather, std::vector<double> dates, DataFrame parameters, std::vector<int> mask, std::vector<std::string> vars, std::vector<int> zones, std::vector<double> weights, std::vector<double> probs, int tile, int threads);
+RcppExport SEXP _LINTULcassava_LC_grid_zonal(SEXP modelSEXP, SEXP weatherSEXP, SEXP datesSEXP, SEXP parametersSEXP, SEXP maskSEXP, SEXP varsSEXP, SEXP zonesSEXP, SEXP weightsSEXP, SEXP probsSEXP, SEXP tileSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type weather(weatherSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type dates(datesSEXP);
+    Rcpp::traits::input_parameter< DataFrame >::type parameters(parametersSEXP);
+    Rcpp::traits::input_parameter< std::vector<int> >::type mask(maskSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type vars(varsSEXP);
+    Rcpp::traits::input_parameter< std::vector<int> >::type zones(zonesSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type probs(probsSEXP);
+    Rcpp::traits::input_parameter< int >::type tile(tileSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_grid_zonal(model, weather, dates, parameters, mask, vars, zones, weights, probs, tile, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_planting
+Rcpp::List LC_planting(SEXP model, std::vector<double> dates, int threads);
+RcppExport SEXP _LINTULcassava_LC_planting(SEXP modelSEXP, SEXP datesSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type dates(datesSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_planting(model, dates, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_ensemble
+Rcpp::List LC_ensemble(SEXP model, double today, List members, int threads);
+RcppExport SEXP _LINTULcassava_LC_ensemble(SEXP modelSEXP, SEXP todaySEXP, SEXP membersSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< double >::type today(todaySEXP);
+    Rcpp::traits::input_parameter< List >::type members(membersSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_ensemble(model, today, members, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_fertilizer
+Rcpp::List LC_fertilizer(SEXP model, List schedules, int threads);
+RcppExport SEXP _LINTULcassava_LC_fertilizer(SEXP modelSEXP, SEXP schedulesSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< List >::type schedules(schedulesSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_fertilizer(model, schedules, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_irrigation
+Rcpp::List LC_irrigation(SEXP model, std::vector<double> frac, std::vector<double> amount, std::vector<double> max, int threads);
+RcppExport SEXP _LINTULcassava_LC_irrigation(SEXP modelSEXP, SEXP fracSEXP, SEXP amountSEXP, SEXP maxSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type frac(fracSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type amount(amountSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type max(maxSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_irrigation(model, frac, amount, max, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_rotation
+Rcpp::List LC_rotation(SEXP model, std::vector<double> plant, std::vector<double> harvest, std::vector<std::string> vars, std::vector<std::string> funs);
+RcppExport SEXP _LINTULcassava_LC_rotation(SEXP modelSEXP, SEXP plantSEXP, SEXP harvestSEXP, SEXP varsSEXP, SEXP funsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type plant(plantSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type harvest(harvestSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type vars(varsSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type funs(funsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_rotation(model, plant, harvest, vars, funs));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_yieldgap
+Rcpp::List LC_yieldgap(SEXP model);
+RcppExport SEXP _LINTULcassava_LC_yieldgap(SEXP modelSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_yieldgap(model));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_scenario
+SEXP LC_scenario(List x);
+RcppExport SEXP _LINTULcassava_LC_scenario(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_scenario(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_set_scenario
+void LC_set_scenario(SEXP model, SEXP scenario);
+RcppExport SEXP _LINTULcassava_LC_set_scenario(SEXP modelSEXP, SEXP scenarioSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type scenario(scenarioSEXP);
+    LC_set_scenario(model, scenario);
+    return R_NilValue;
+END_RCPP
+}
+// LC_scenarios
+Rcpp::List LC_scenarios(SEXP model, List scenarios, int threads);
+RcppExport SEXP _LINTULcassava_LC_scenarios(SEXP modelSEXP, SEXP scenariosSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< List >::type scenarios(scenariosSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_scenarios(model, scenarios, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_generator
+SEXP LC_generator(SEXP weather);
+RcppExport SEXP _LINTULcassava_LC_generator(SEXP weatherSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type weather(weatherSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_generator(weather));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_generate
+Rcpp::List LC_generate(SEXP generator, std::vector<double> dates, double seed);
+RcppExport SEXP _LINTULcassava_LC_generate(SEXP generatorSEXP, SEXP datesSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type generator(generatorSEXP);
+    Rcpp::traits::input_parameter< std::vector<double> >::type dates(datesSEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_generate(generator, dates, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_stochastic
+Rcpp::List LC_stochastic(SEXP model, SEXP generator, int n, double seed, int threads);
+RcppExport SEXP _LINTULcassava_LC_stochastic(SEXP modelSEXP, SEXP generatorSEXP, SEXP nSEXP, SEXP seedSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type generator(generatorSEXP);
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_stochastic(model, generator, n, seed, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_start
+void LC_start(SEXP model);
+RcppExport SEXP _LINTULcassava_LC_start(SEXP modelSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    LC_start(model);
+    return R_NilValue;
+END_RCPP
+}
+// LC_advance
+bool LC_advance(SEXP model, double date);
+RcppExport SEXP _LINTULcassava_LC_advance(SEXP modelSEXP, SEXP dateSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< double >::type date(dateSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_advance(model, date));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_finish
+Rcpp::List LC_finish(SEXP model);
+RcppExport SEXP _LINTULcassava_LC_finish(SEXP modelSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_finish(model));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_fork
+Rcpp::List LC_fork(SEXP model, int n);
+RcppExport SEXP _LINTULcassava_LC_fork(SEXP modelSEXP, SEXP nSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_fork(model, n));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_snapshot
+SEXP LC_snapshot(SEXP model);
+RcppExport SEXP _LINTULcassava_LC_snapshot(SEXP modelSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_snapshot(model));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_restore
+void LC_restore(SEXP model, SEXP snapshot);
+RcppExport SEXP _LINTULcassava_LC_restore(SEXP modelSEXP, SEXP snapshotSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type snapshot(snapshotSEXP);
+    LC_restore(model, snapshot);
+    return R_NilValue;
+END_RCPP
+}
+// LC_checkpoint
+Rcpp::RawVector LC_checkpoint(SEXP model);
+RcppExport SEXP _LINTULcassava_LC_checkpoint(SEXP modelSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_checkpoint(model));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_resume
+void LC_resume(SEXP model, Rcpp::RawVector checkpoint);
+RcppExport SEXP _LINTULcassava_LC_resume(SEXP modelSEXP, SEXP checkpointSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< Rcpp::RawVector >::type checkpoint(checkpointSEXP);
+    LC_resume(model, checkpoint);
+    return R_NilValue;
+END_RCPP
+}
+// LC_nowcast
+SEXP LC_nowcast(SEXP model, int interval);
+RcppExport SEXP _LINTULcassava_LC_nowcast(SEXP modelSEXP, SEXP intervalSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    Rcpp::traits::input_parameter< int >::type interval(intervalSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_nowcast(model, interval));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_update
+Rcpp::List LC_update(List nowcasts, List weather, double today, int threads);
+RcppExport SEXP _LINTULcassava_LC_update(SEXP nowcastsSEXP, SEXP weatherSEXP, SEXP todaySEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type nowcasts(nowcastsSEXP);
+    Rcpp::traits::input_parameter< List >::type weather(weatherSEXP);
+    Rcpp::traits::input_parameter< double >::type today(todaySEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_update(nowcasts, weather, today, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// LC_allocations
+std::vector<double> LC_allocations(SEXP model);
+RcppExport SEXP _LINTULcassava_LC_allocations(SEXP modelSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type model(modelSEXP);
+    rcpp_result_gen = Rcpp::wrap(LC_allocations(model));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 RcppExport SEXP _rcpp_module_boot_LINcas();
 
 static const R_CallMethodDef CallEntries[] = {
+    {"_LINTULcassava_LC_weather", (DL_FUNC) &_LINTULcassava_LC_weather, 1},
     {"_LINTULcassava_LC", (DL_FUNC) &_LINTULcassava_LC, 5},
+    {"_LINTULcassava_LC_prepare", (DL_FUNC) &_LINTULcassava_LC_prepare, 4},
+    {"_LINTULcassava_LC_set", (DL_FUNC) &_LINTULcassava_LC_set, 6},
+    {"_LINTULcassava_LC_run", (DL_FUNC) &_LINTULcassava_LC_run, 1},
+    {"_LINTULcassava_LC_sweep", (DL_FUNC) &_LINTULcassava_LC_sweep, 3},
+    {"_LINTULcassava_LC_sweep_file", (DL_FUNC) &_LINTULcassava_LC_sweep_file, 4},
+    {"_LINTULcassava_LC_output_open", (DL_FUNC) &_LINTULcassava_LC_output_open, 1},
+    {"_LINTULcassava_LC_output_info", (DL_FUNC) &_LINTULcassava_LC_output_info, 2},
+    {"_LINTULcassava_LC_output_read", (DL_FUNC) &_LINTULcassava_LC_output_read, 3},
+    {"_LINTULcassava_LC_screen", (DL_FUNC) &_LINTULcassava_LC_screen, 6},
+    {"_LINTULcassava_LC_grid", (DL_FUNC) &_LINTULcassava_LC_grid, 8},
+    {"_LINTULcassava_LC_batch", (DL_FUNC) &_LINTULcassava_LC_batch, 4},
+    {"_LINTULcassava_LC_grid_zonal", (DL_FUNC) &_LINTULcassava_LC_grid_zonal, 11},
+    {"_LINTULcassava_LC_planting", (DL_FUNC) &_LINTULcassava_LC_planting, 3},
+    {"_LINTULcassava_LC_ensemble", (DL_FUNC) &_LINTULcassava_LC_ensemble, 4},
+    {"_LINTULcassava_LC_fertilizer", (DL_FUNC) &_LINTULcassava_LC_fertilizer, 3},
+    {"_LINTULcassava_LC_irrigation", (DL_FUNC) &_LINTULcassava_LC_irrigation, 5},
+    {"_LINTULcassava_LC_rotation", (DL_FUNC) &_LINTULcassava_LC_rotation, 5},
+    {"_LINTULcassava_LC_yieldgap", (DL_FUNC) &_LINTULcassava_LC_yieldgap, 1},
+    {"_LINTULcassava_LC_scenario", (DL_FUNC) &_LINTULcassava_LC_scenario, 1},
+    {"_LINTULcassava_LC_set_scenario", (DL_FUNC) &_LINTULcassava_LC_set_scenario, 2},
+    {"_LINTULcassava_LC_scenarios", (DL_FUNC) &_LINTULcassava_LC_scenarios, 3},
+    {"_LINTULcassava_LC_generator", (DL_FUNC) &_LINTULcassava_LC_generator, 1},
+    {"_LINTULcassava_LC_generate", (DL_FUNC) &_LINTULcassava_LC_generate, 3},
+    {"_LINTULcassava_LC_stochastic", (DL_FUNC) &_LINTULcassava_LC_stochastic, 5},
+    {"_LINTULcassava_LC_start", (DL_FUNC) &_LINTULcassava_LC_start, 1},
+    {"_LINTULcassava_LC_advance", (DL_FUNC) &_LINTULcassava_LC_advance, 2},
+    {"_LINTULcassava_LC_finish", (DL_FUNC) &_LINTULcassava_LC_finish, 1},
+    {"_LINTULcassava_LC_fork", (DL_FUNC) &_LINTULcassava_LC_fork, 2},
+    {"_LINTULcassava_LC_snapshot", (DL_FUNC) &_LINTULcassava_LC_snapshot, 1},
+    {"_LINTULcassava_LC_restore", (DL_FUNC) &_LINTULcassava_LC_restore, 2},
+    {"_LINTULcassava_LC_checkpoint", (DL_FUNC) &_LINTULcassava_LC_checkpoint, 1},
+    {"_LINTULcassava_LC_resume", (DL_FUNC) &_LINTULcassava_LC_resume, 2},
+    {"_LINTULcassava_LC_nowcast", (DL_FUNC) &_LINTULcassava_LC_nowcast, 2},
+    {"_LINTULcassava_LC_update", (DL_FUNC) &_LINTULcassava_LC_update, 4},
+    {"_LINTULcassava_LC_allocations", (DL_FUNC) &_LINTULcassava_LC_allocations, 1},
     {"_rcpp_module_boot_LINcas", (DL_FUNC) &_rcpp_module_boot_LINcas, 0},
     {NULL, NULL, 0}
 };
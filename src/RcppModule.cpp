@@ -8,18 +8,46 @@ License: EUPL
 #include "LINTcas.h"
 
 void setWeather(LINcasModel* m, Rcpp::NumericVector date, Rcpp::NumericVector tmin, Rcpp::NumericVector tmax, Rcpp::NumericVector srad, Rcpp::NumericVector prec, Rcpp::NumericVector wind, Rcpp::NumericVector vapr) {
-	LINcasWeather wth;
-	wth.tmin = Rcpp::as<std::vector<double>>(tmin);
-	wth.tmax = Rcpp::as<std::vector<double>>(tmax);
-	wth.srad = Rcpp::as<std::vector<double>>(srad);
-	wth.wind = Rcpp::as<std::vector<double>>(wind);
-	wth.vapr = Rcpp::as<std::vector<double>>(vapr);
-	wth.prec = Rcpp::as<std::vector<double>>(prec);
-	wth.date = Rcpp::as<std::vector<long>>(date);
-	m->weather = wth;
+	std::shared_ptr<LINcasWeatherData> wth = std::make_shared<LINcasWeatherData>();
+	wth->tmin = Rcpp::as<std::vector<double>>(tmin);
+	wth->tmax = Rcpp::as<std::vector<double>>(tmax);
+	wth->srad = Rcpp::as<std::vector<double>>(srad);
+	wth->wind = Rcpp::as<std::vector<double>>(wind);
+	wth->vapr = Rcpp::as<std::vector<double>>(vapr);
+	wth->prec = Rcpp::as<std::vector<double>>(prec);
+	wth->date = Rcpp::as<std::vector<long>>(date);
+	m->weather.set(wth);
 }
 
-RCPP_EXPOSED_CLASS(LINcasWeather)
+// the "weather" field of a model; a copy of the weather that it uses
+LINcasWeatherData getModelWeather(LINcasModel* m) {
+	LINcasWeatherData w;
+	w.date.assign(m->weather.date.begin(), m->weather.date.end());
+	w.srad.assign(m->weather.srad.begin(), m->weather.srad.end());
+	w.tmin.assign(m->weather.tmin.begin(), m->weather.tmin.end());
+	w.tmax.assign(m->weather.tmax.begin(), m->weather.tmax.end());
+	w.prec.assign(m->weather.prec.begin(), m->weather.prec.end());
+	w.wind.assign(m->weather.wind.begin(), m->weather.wind.end());
+	w.vapr.assign(m->weather.vapr.begin(), m->weather.vapr.end());
+	return w;
+}
+
+void setModelWeather(LINcasModel* m, LINcasWeatherData w) {
+	m->weather.set(std::make_shared<const LINcasWeatherData>(std::move(w)));
+}
+
+// tables are exposed as a list of columns
+template <LINcasTable LINcasCropParameters::* tb>
+std::vector<std::vector<double>> getCropTable(LINcasCropParameters* p) {
+	return (p->*tb).values();
+}
+
+template <LINcasTable LINcasCropParameters::* tb>
+void setCropTable(LINcasCropParameters* p, std::vector<std::vector<double>> x) {
+	p->*tb = LINcasTable(x);
+}
+
+RCPP_EXPOSED_CLASS(LINcasWeatherData)
 RCPP_EXPOSED_CLASS(LINcasCropParameters)
 RCPP_EXPOSED_CLASS(LINcasSoilParameters)
 RCPP_EXPOSED_CLASS(LINcasManagement)
@@ -37,84 +65,43 @@ RCPP_MODULE(LINcas){
 		.field("outvars",  &LINcasControl::outvars)
 	;
 
+#define LC_FIELD(name) .field(#name, &LINcasManagement::name)
+#define LC_FIELDV(name, value) .field(#name, &LINcasManagement::name)
     class_<LINcasManagement>("LINcasManagement")
-		.field("PLDATE", &LINcasManagement::PLDATE) 
-		.field("HVDATE", &LINcasManagement::HVDATE)
+		LC_MANAGEMENT_PARAMETERS(LC_FIELD)
+		LC_MANAGEMENT_OPTIONAL(LC_FIELDV)
 	;
+#undef LC_FIELD
+#undef LC_FIELDV
 
-    class_<LINcasWeather>("LINcasWeather")
+    class_<LINcasWeatherData>("LINcasWeather")
 		.constructor()
-		.field("date", &LINcasWeather::date) 
-		.field("srad", &LINcasWeather::srad) 
-		.field("tmin", &LINcasWeather::tmin) 
-		.field("tmax", &LINcasWeather::tmax) 
-		.field("prec", &LINcasWeather::prec) 
-		.field("wind", &LINcasWeather::wind) 
-		.field("vapr", &LINcasWeather::vapr) 
+		.field("date", &LINcasWeatherData::date) 
+		.field("srad", &LINcasWeatherData::srad) 
+		.field("tmin", &LINcasWeatherData::tmin) 
+		.field("tmax", &LINcasWeatherData::tmax) 
+		.field("prec", &LINcasWeatherData::prec) 
+		.field("wind", &LINcasWeatherData::wind) 
+		.field("vapr", &LINcasWeatherData::vapr) 
 	;
 	
+#define LC_FIELD(name) .field(#name, &LINcasCropParameters::name)
+#define LC_TABLE_FIELD(name, ncol) .property(#name, &getCropTable<&LINcasCropParameters::name>, &setCropTable<&LINcasCropParameters::name>)
 	class_<LINcasCropParameters>("LINcasCropParameters")
-		.field("TWCSD", &LINcasCropParameters::TWCSD)
-		.field("FRACRNINTC", &LINcasCropParameters::FRACRNINTC)
-		.field("RECOV", &LINcasCropParameters::RECOV)
-		.field("TRANCO", &LINcasCropParameters::TRANCO)
-		.field("WCUTTINGUNIT", &LINcasCropParameters::WCUTTINGUNIT)
-		.field("NCUTTINGS", &LINcasCropParameters::NCUTTINGS)
-		.field("WCUTTINGIP", &LINcasCropParameters::WCUTTINGIP)
-		.field("ROOTDI", &LINcasCropParameters::ROOTDI)
-		.field("SLAI", &LINcasCropParameters::SLAI)
-		.field("WLVI", &LINcasCropParameters::WLVI)
-		.field("LAII", &LINcasCropParameters::LAII)
-		.field("WCUTTINGMINPRO", &LINcasCropParameters::WCUTTINGMINPRO)
-		.field("FST_CUTT", &LINcasCropParameters::FST_CUTT)
-		.field("FRT_CUTT", &LINcasCropParameters::FRT_CUTT)
-		.field("FLV_CUTT", &LINcasCropParameters::FLV_CUTT)
-		.field("FSO_CUTT", &LINcasCropParameters::FSO_CUTT)
-		.field("RDRWCUTTING", &LINcasCropParameters::RDRWCUTTING)
-		.field("FPAR", &LINcasCropParameters::FPAR)
-		.field("K_EXT", &LINcasCropParameters::K_EXT)
-		.field("LUE_OPT", &LINcasCropParameters::LUE_OPT)
-		.field("RRDMAX", &LINcasCropParameters::RRDMAX)
-		.field("RDRB", &LINcasCropParameters::RDRB)
-		.field("LAICR", &LINcasCropParameters::LAICR)
-		.field("RDRSHM", &LINcasCropParameters::RDRSHM)
-		.field("FRACTLLFENHSH", &LINcasCropParameters::FRACTLLFENHSH)
-		.field("FASTRANSLSO", &LINcasCropParameters::FASTRANSLSO)
-		.field("SLA_MAX", &LINcasCropParameters::SLA_MAX)
-		.field("RGRL", &LINcasCropParameters::RGRL)
-		.field("LAIEXPOEND", &LINcasCropParameters::LAIEXPOEND)
-		.field("TBASE", &LINcasCropParameters::TBASE)
-		.field("OPTEMERGTSUM", &LINcasCropParameters::OPTEMERGTSUM)
-		.field("TSUMLA_MIN", &LINcasCropParameters::TSUMLA_MIN)
-		.field("TSUMSBR", &LINcasCropParameters::TSUMSBR)
-		.field("TSUMLLIFE", &LINcasCropParameters::TSUMLLIFE)
-		.field("TSUMREDISTMAX", &LINcasCropParameters::TSUMREDISTMAX)
-		.field("FINTSUM", &LINcasCropParameters::FINTSUM)
-		.field("LAI_MIN", &LINcasCropParameters::LAI_MIN)
-		.field("WSOREDISTFRACMAX", &LINcasCropParameters::WSOREDISTFRACMAX)
-		.field("WLVGNEWN", &LINcasCropParameters::WLVGNEWN)
-		.field("SO2LV", &LINcasCropParameters::SO2LV)
-		.field("RRREDISTSO", &LINcasCropParameters::RRREDISTSO)
-		.field("DELREDIST", &LINcasCropParameters::DELREDIST)
-		.field("FRACSLATB", &LINcasCropParameters::FRACSLATB)
-		.field("RDRT", &LINcasCropParameters::RDRT)
-		.field("TTB", &LINcasCropParameters::TTB)
-		.field("FLVTB", &LINcasCropParameters::FLVTB)
-		.field("FSTTB", &LINcasCropParameters::FSTTB)
-		.field("FSOTB", &LINcasCropParameters::FSOTB)
-		.field("FRTTB", &LINcasCropParameters::FRTTB)
-		.field("SLAII", &LINcasCropParameters::SLAII)
+		LC_CROP_PARAMETERS(LC_FIELD)
+		LC_CROP_TABLES(LC_TABLE_FIELD)
+		LC_CROP_NPK_PARAMETERS(LC_FIELD)
+		LC_CROP_NPK_TABLES(LC_TABLE_FIELD)
 	;
+#undef LC_FIELD
+#undef LC_TABLE_FIELD
 
+#define LC_FIELD(name) .field(#name, &LINcasSoilParameters::name)
     class_<LINcasSoilParameters>("LINcasSoilParameters")
-		.field("ROOTDM", &LINcasSoilParameters::ROOTDM)
-		.field("WCAD", &LINcasSoilParameters::WCAD)
-		.field("WCWP", &LINcasSoilParameters::WCWP)
-		.field("WCFC", &LINcasSoilParameters::WCFC)
-		.field("WCWET", &LINcasSoilParameters::WCWET)
-		.field("WCST", &LINcasSoilParameters::WCST)
-		.field("DRATE", &LINcasSoilParameters::DRATE)	
+		LC_SOIL_PARAMETERS(LC_FIELD)
+		LC_SOIL_NPK_PARAMETERS(LC_FIELD)
 	;
+#undef LC_FIELD
 	
     class_<LINcasOutput>("LINcasOutput")
 		.field("names", &LINcasOutput::names, "names")
@@ -125,8 +112,9 @@ RCPP_MODULE(LINcas){
 		.constructor()
 		.method("run", &LINcasModel::run, "run the model")		
 //		.method("run_batch", &LINcasModel::run_batch, "run the model")		
+		.method("setWeather", &setWeather, "set the weather")		
 		.field("control", &LINcasModel::control, "control")
-		.field("weather", &LINcasModel::weather, "weather")
+		.property("weather", &getModelWeather, &setModelWeather, "weather")
 		.field("output", &LINcasModel::out, "output")
 		.field("messages", &LINcasModel::messages, "messages")
 //		.field("fatalError", &LINcasModel::fatalError, "fatalError")
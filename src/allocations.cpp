@@ -0,0 +1,95 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+
+Counting memory allocations, to test that models that are reused do not allocate 
+memory. The global operator new is only replaced if the package is compiled with 
+-DLC_COUNT_ALLOCATIONS (for example with PKG_CPPFLAGS in ~/.R/Makevars). It then 
+counts the allocations of the calling thread while a counter is set (in 
+LC_allocations). Otherwise .LC_allocations returns NAs
+*/
+
+#include <Rcpp.h>
+#include "LINTcas.h"
+
+#ifdef LC_COUNT_ALLOCATIONS
+
+#include <new>
+#include <cstdlib>
+
+static thread_local long* nalloc = nullptr;
+
+void* operator new(std::size_t n) {
+	if (nalloc != nullptr) (*nalloc)++;
+	void *p = std::malloc(n > 0 ? n : 1);
+	if (p == nullptr) throw std::bad_alloc();
+	return p;
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+#endif
+
+
+// number of allocations for each day of a model run (NA with multiple harvest
+// dates), and when the model is run again, or reused for another job in a 
+// sweep. These should all be zero
+// [[Rcpp::export(".LC_allocations")]]
+std::vector<double> LC_allocations(SEXP model) {
+	Rcpp::XPtr<LINcasModel> m(model);
+	if (m->weather.data == nullptr) {
+		Rcpp::stop("no weather data");
+	}
+	std::vector<double> r(3, NA_REAL);
+
+#ifdef LC_COUNT_ALLOCATIONS
+	long count = 0;
+	nalloc = &count;
+	// check that the allocations of the model are counted
+	::operator delete(::operator new(16));
+	if (count == 0) {
+		nalloc = nullptr;
+		Rcpp::stop("allocations are not counted");
+	}
+
+	LINcasOverlay ov;
+	LINcasModel a, b;
+	ov.apply(*m, a);
+	ov.apply(*m, b);
+	b.management.HVDATE -= 30;
+	b.management.harvests.clear();
+	bool single = !a.multipleHarvests();
+
+	// fresh models, with a different number of days
+	long n0 = count;
+	a.run();
+	long na = count - n0;
+	n0 = count;
+	b.run();
+	long nb = count - n0;
+	if (a.fatalError || b.fatalError) {
+		nalloc = nullptr;
+		Rcpp::stop("the model could not be run");
+	}
+	double ndays = double(a.out.values.size()) / a.out.names.size() - double(b.out.values.size()) / b.out.names.size();
+	if (single && (ndays > 0)) {
+		r[0] = (na - nb) / ndays;
+	}
+
+	// run again
+	n0 = count;
+	a.run();
+	r[1] = count - n0;
+
+	// another job
+	ov.values.push_back({LC_parameter_index("LUE_OPT"), 0.9 * m->crop.LUE_OPT});
+	n0 = count;
+	ov.apply(*m, a);
+	a.run();
+	r[2] = count - n0;
+	nalloc = nullptr;
+#endif
+
+	return r;
+}
@@ -0,0 +1,57 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <thread>
+#include "LINTcas.h"
+#include "parallel.h"
+
+
+// a weather file that was read, or the reason why it could not be read
+struct LINcasBatchFile {
+	std::shared_ptr<const LINcasWeatherData> weather;
+	std::string msg;
+};
+
+
+// Run the model with the weather in each of "files" (csv, see
+// LINcasWeatherData::read). The files are read, in order, by a separate
+// thread, while the other threads run the model with the weather that was
+// read before. At most "prefetch" files are read ahead, such that the memory
+// used does not depend on the number of files. The output has the states at
+// harvest for each file. These are NAN for a file that could not be read (or
+// run), and that does not stop the batch
+bool LC_batch_run(const LINcasModel &base, const std::vector<std::string> &files, size_t nthreads, size_t prefetch, LINcasOutput &out, std::vector<std::string> &messages) {
+
+	size_t n = files.size();
+	if (n == 0) {
+		messages.push_back("no weather files");
+		return false;
+	}
+	LC_prefetch<LINcasBatchFile> queue(prefetch);
+	std::thread reader([&]() {
+		for (size_t i=0; i<n; i++) {
+			std::shared_ptr<LINcasWeatherData> w = std::make_shared<LINcasWeatherData>();
+			std::string msg;
+			if (!w->read(files[i], msg)) w = nullptr;
+			queue.put(i, {w, msg});
+		}
+	});
+
+	std::vector<double> keys(n);
+	for (size_t i=0; i<n; i++) keys[i] = i + 1;
+	LC_runs(base, "file", keys, nthreads, [&](size_t i, LINcasModel &m) {
+		LINcasBatchFile f = queue.take(i);
+		if (!f.weather) {
+			m.messages.push_back(f.msg);
+			return false;
+		}
+		m.weather.set(f.weather);
+		m.weather.generator = nullptr;
+		return m.start();
+	}, out, messages);
+	reader.join();
+	return true;
+}
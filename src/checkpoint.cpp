@@ -0,0 +1,279 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+
+Binary checkpoints of a running model. A checkpoint has the state at the start 
+of a day, and hashes of the inputs, so that a simulation can be continued in 
+another process, with the same parameters and weather (that may have been 
+extended with new days). 
+
+Layout (native byte order, checked with a marker):
+	"LCCK", uint32 version, uint32 byte order marker, 
+	uint64 schema hash, uint64 parameter hash, uint64 weather hash,
+	int64 start date, int64 current date, uint32 step, season_length, maxdur, 
+	uint64 nextharvest, uint8 ended, uint8 emerged, double DELT, 
+	uint32 event flags, dormancy, redist (the event log), 
+	3 x double (soil mineralization rates), 
+	uint32 length, the weather generator state (text; empty without generator), 
+	uint32 number of variables, the states, the rates
+*/
+
+#include <cstring>
+#include <algorithm>
+#include "LINTcas.h"
+
+static const uint32_t LC_CHECKPOINT_VERSION = 2;
+static const uint32_t LC_BYTE_ORDER = 0x01020304;
+
+
+class LINcasHash {
+public:
+	uint64_t h = 14695981039346656037ull;
+	void add(const void* p, size_t n) {
+		const unsigned char *b = (const unsigned char*) p;
+		for (size_t i=0; i<n; i++) {
+			h ^= b[i];
+			h *= 1099511628211ull;
+		}
+	}
+	template <class T> void add(const T &x) { add(&x, sizeof(T)); }
+	void add(const std::string &s) { add(s.data(), s.size()); add(uint8_t(0)); }
+};
+
+
+// the names of the variables, so that checkpoints are only used with the same model version
+static uint64_t schemaHash() {
+	LINcasHash h;
+	for (const LINcasVariable &v : LC_variables()) {
+		h.add(v.name);
+	}
+	return h.h;
+}
+
+
+uint64_t LINcasModel::parameterHash() const {
+	LINcasHash h;
+	for (const LINcasParameter &p : LC_parameters()) {
+		// the NPK parameters are not set (and not used) if the model is not NPK
+		if (p.npk && !control.NPKmodel) continue;
+		h.add(p.name);
+		if (p.ncol == 0) {
+			h.add(p.get(*this));
+		} else {
+			const LINcasTable &tb = p.table(*this);
+			for (size_t i=0; i<tb.size(); i++) {
+				h.add(tb[i].data(), tb[i].size() * sizeof(double));
+				h.add(tb[i].size());
+			}
+		}
+	}
+	for (long d : management.harvests) h.add(d);
+	h.add(control.NPKmodel);
+	h.add(control.water_limited);
+	h.add(control.nutrient_limited);
+	h.add(control.DELT);
+	h.add(control.modelstart);
+	if (weather.transform) {
+		const LINcasWeatherTransform &t = *weather.transform;
+		h.add(t.dtmin);
+		h.add(t.dtmax);
+		h.add(t.fsrad);
+		h.add(t.fprec);
+		h.add(t.fwind);
+		h.add(t.fvapr);
+		h.add(t.rh);
+	}
+	if (weather.generator) {
+		h.add(*weather.generator);
+		h.add(weather.seed);
+	}
+	return h.h;
+}
+
+
+// the weather for days "from" to (not including) "to" 
+uint64_t LINcasModel::weatherHash(size_t from, size_t to) const {
+	LINcasHash h;
+	to = std::min(to, weather.date.size());
+	for (size_t i=from; i<to; i++) {
+		h.add(weather.date[i]);
+		h.add(weather.srad[i]);
+		h.add(weather.tmin[i]);
+		h.add(weather.tmax[i]);
+		h.add(weather.prec[i]);
+		h.add(weather.wind[i]);
+		h.add(weather.vapr[i]);
+	}
+	return h.h;
+}
+
+
+class LINcasWriter {
+public:
+	std::vector<unsigned char> b;
+	template <class T> void add(const T &x) {
+		const unsigned char *p = (const unsigned char*) &x;
+		b.insert(b.end(), p, p + sizeof(T));
+	}
+};
+
+class LINcasReader {
+public:
+	LINcasReader(const std::vector<unsigned char> &x) : b(x) {}
+	template <class T> bool get(T &x) {
+		if ((pos + sizeof(T)) > b.size()) return false;
+		std::memcpy(&x, b.data() + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+	bool get(std::string &s, size_t n) {
+		if ((pos + n) > b.size()) return false;
+		s.assign((const char*) b.data() + pos, n);
+		pos += n;
+		return true;
+	}
+	const std::vector<unsigned char> &b;
+	size_t pos = 0;
+};
+
+
+// the index of a date in the weather data
+static bool dateIndex(const LINcasWeather &w, long date, size_t &i) {
+	const long* it = std::find(w.date.begin(), w.date.end(), date);
+	if (it == w.date.end()) return false;
+	i = it - w.date.begin();
+	return true;
+}
+
+
+std::vector<unsigned char> LINcasModel::checkpoint() const {
+	LINcasWriter w;
+	w.b.reserve(128 + 2 * LC_variables().size() * sizeof(double));
+	w.b.insert(w.b.end(), {'L', 'C', 'C', 'K'});
+	w.add(LC_CHECKPOINT_VERSION);
+	w.add(LC_BYTE_ORDER);
+	w.add(schemaHash());
+	w.add(parameterHash());
+	size_t first = 0;
+	dateIndex(weather, control.modelstart, first);
+	w.add(weatherHash(first, time));
+	w.add(int64_t(control.modelstart));
+	// the date of the next day to simulate (that may not be in the weather data yet)
+	int64_t date = control.modelstart;
+	if (time < weather.date.size()) {
+		date = weather.date[time];
+	} else if (time > first) {
+		date = weather.date[time-1] + 1;
+	}
+	w.add(date);
+	w.add(uint32_t(step));
+	w.add(uint32_t(season_length));
+	w.add(uint32_t(maxdur));
+	w.add(uint64_t(nextharvest));
+	w.add(uint8_t(ended));
+	w.add(uint8_t(emerged));
+	w.add(DELT);
+	w.add(uint32_t(eventlog.flags));
+	w.add(uint32_t(eventlog.dormancy));
+	w.add(uint32_t(eventlog.redist));
+	w.add(soil.RTNMINS);
+	w.add(soil.RTPMINS);
+	w.add(soil.RTKMINS);
+	std::string ws = weather.generator ? wstate.str() : "";
+	w.add(uint32_t(ws.size()));
+	w.b.insert(w.b.end(), ws.begin(), ws.end());
+	const std::vector<LINcasVariable> &vars = LC_variables();
+	w.add(uint32_t(vars.size()));
+	for (const LINcasVariable &v : vars) w.add(S.*v.value);
+	for (const LINcasVariable &v : vars) w.add(R.*v.value);
+	return w.b;
+}
+
+
+// continue from a checkpoint. The model must have the same parameters, and the 
+// same weather up to the day of the checkpoint. The output has the days after 
+// the checkpoint
+bool LINcasModel::resume(const std::vector<unsigned char> &x, std::string &msg) {
+	LINcasReader r(x);
+	char magic[4];
+	uint32_t version, order, nvars, u_step, u_season, u_maxdur, u_flags, u_dormancy, u_redist, nws;
+	uint64_t schema, phash, whash, u_next;
+	int64_t startdate, date;
+	uint8_t u_ended, u_emerged;
+	double delt;
+	std::string ws;
+	LINcasSnapshot s;
+	if (!(r.get(magic) && (std::memcmp(magic, "LCCK", 4) == 0))) {
+		msg = "not a checkpoint";
+		return false;
+	}
+	if (!(r.get(version) && r.get(order))) {
+		msg = "invalid checkpoint";
+		return false;
+	}
+	if (version != LC_CHECKPOINT_VERSION) {
+		msg = "checkpoint version " + std::to_string(version) + " is not supported";
+		return false;
+	}
+	if (order != LC_BYTE_ORDER) {
+		msg = "checkpoint has a different byte order";
+		return false;
+	}
+	bool ok = r.get(schema) && r.get(phash) && r.get(whash) && r.get(startdate) && r.get(date) && 
+		r.get(u_step) && r.get(u_season) && r.get(u_maxdur) && r.get(u_next) && r.get(u_ended) && 
+		r.get(u_emerged) && r.get(delt) && r.get(u_flags) && r.get(u_dormancy) && r.get(u_redist) && 
+		r.get(s.RTNMINS) && r.get(s.RTPMINS) && r.get(s.RTKMINS) && r.get(nws) && r.get(ws, nws) && 
+		r.get(nvars);
+	const std::vector<LINcasVariable> &vars = LC_variables();
+	if ((!ok) || (nvars != vars.size()) || (x.size() != (r.pos + 2 * nvars * sizeof(double)))) {
+		msg = "invalid checkpoint";
+		return false;
+	}
+	if (schema != schemaHash()) {
+		msg = "checkpoint is from another version of the model";
+		return false;
+	}
+	if (phash != parameterHash()) {
+		msg = "the parameters are not the same as those of the checkpoint";
+		return false;
+	}
+	// the weather may not go beyond the day of the checkpoint yet
+	reset();
+	if (!start(true)) {
+		msg = messages.empty() ? "cannot start the model" : messages.back();
+		return false;
+	}
+	size_t first, now;
+	if (!dateIndex(weather, startdate, first)) {
+		msg = "the start date of the checkpoint is not in the weather data";
+		return false;
+	}
+	if (!dateIndex(weather, date, now)) {
+		// the checkpoint is at the end of the simulation
+		now = first + (date - startdate);
+	}
+	if (weatherHash(first, now) != whash) {
+		msg = "the weather is not the same as that of the checkpoint";
+		return false;
+	}
+	for (const LINcasVariable &v : vars) r.get(s.S.*v.value);
+	for (const LINcasVariable &v : vars) r.get(s.R.*v.value);
+	s.step = u_step;
+	s.time = now;
+	s.season_length = u_season;
+	s.maxdur = u_maxdur;
+	s.nextharvest = u_next;
+	s.ended = u_ended;
+	s.emerged = u_emerged;
+	s.eventlog.flags = u_flags;
+	s.eventlog.dormancy = u_dormancy;
+	s.eventlog.redist = u_redist;
+	if (weather.generator && !s.wstate.set(ws)) {
+		msg = "invalid checkpoint";
+		return false;
+	}
+	restore(s);
+	DELT = delt;
+	return true;
+}
@@ -0,0 +1,74 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <algorithm>
+#include "LINTcas.h"
+
+
+// In-season forecast. The model is run with the observed weather (of the base 
+// model) up to and including "today", and then continued, from that state, with 
+// the weather of each ensemble member (from the day after today; the weather is
+// not copied). 
+// The output has the states at harvest for each member 
+bool LC_ensemble_forecast(const LINcasModel &base, long today, const std::vector<std::shared_ptr<const LINcasWeatherData>> &members, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages) {
+
+	if (members.empty()) {
+		messages.push_back("no ensemble members");
+		return false;
+	}
+	if (today < base.control.modelstart) {
+		messages.push_back("today is before the start of the model");
+		return false;
+	}
+
+	LINcasOverlay ov;
+	LINcasModel obs;
+	ov.apply(base, obs);
+	obs.control.outvars = "batch";
+	obs.management.harvests.clear();
+	obs.reset();
+	if (!obs.start(true)) {
+		messages = obs.messages;
+		return false;
+	}
+	// the shared part, with observed weather
+	while ((!obs.ended) && (obs.time < obs.weather.date.size()) && (obs.weather.date[obs.time] <= today)) {
+		obs.step_day(today);
+	}
+	if (obs.fatalError) {
+		messages = obs.messages;
+		return false;
+	}
+	if ((!obs.ended) && (obs.weather.date[obs.time-1] != today)) {
+		messages.push_back("the observed weather does not go up to today");
+		return false;
+	}
+	LINcasSnapshot x = obs.snapshot();
+
+	// continue with the weather of each member
+	messages = obs.messages;
+	std::vector<double> keys(members.size());
+	for (size_t i=0; i<keys.size(); i++) keys[i] = i + 1;
+	return LC_runs(obs, "member", keys, nthreads, [&](size_t i, LINcasModel &m) {
+		if (!m.start(true)) return false;
+		m.restore(x);
+		if (!x.ended) {
+			const std::vector<long> &d = members[i]->date;
+			auto it = std::find(d.begin(), d.end(), today + 1);
+			if (it == d.end()) {
+				m.messages.push_back("the weather of an ensemble member does not start on the day after today");
+				return false;
+			}
+			m.weather.set(members[i], it - d.begin());
+			m.time = 0;
+			if (m.weather.date.size() < (m.maxdur - m.step + 1)) {
+				m.messages.push_back("harvest date beyond the end of the weather of an ensemble member");
+				return false;
+			}
+		}
+		return true;
+	}, out, messages);
+}
@@ -0,0 +1,74 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <algorithm>
+#include "LINTcas.h"
+
+
+// Fertilizer schedules (FERTAB tables) of an NPK model. All schedules are the 
+// same as no fertilizer until the first application. That part is therefore 
+// simulated only once, without fertilizer, and each schedule is started from 
+// that trajectory on the day of its first application. 
+// The output has the states at harvest for each schedule
+bool LC_fertilizer_sweep(const LINcasModel &base, const std::vector<LINcasTable> &schedules, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages) {
+
+	if (!base.control.NPKmodel) {
+		messages.push_back("fertilizer schedules can only be used with the NPK model");
+		return false;
+	}
+	size_t n = schedules.size();
+	// the date of the first application of each schedule
+	std::vector<long> first(n);
+	for (size_t i=0; i<n; i++) {
+		const LINcasTable &f = schedules[i];
+		if ((f.size() != 4) || (f[0].size() == 0)) {
+			first[i] = base.management.HVDATE + 1; // no fertilizer
+		} else {
+			first[i] = base.management.PLDATE + long(*std::min_element(f[0].begin(), f[0].end()));
+		}
+	}
+	std::vector<long> dates = first;
+	std::sort(dates.begin(), dates.end());
+	dates.erase(std::unique(dates.begin(), dates.end()), dates.end());
+
+	// the shared trajectory without fertilizer
+	LINcasOverlay ov;
+	LINcasModel pre;
+	ov.apply(base, pre);
+	pre.control.outvars = "batch";
+	pre.management.harvests.clear();
+	pre.management.FERTAB = LINcasTable(std::vector<std::vector<double>>(4));
+	pre.reset();
+	if (!pre.start()) {
+		messages = pre.messages;
+		return false;
+	}
+	std::vector<LINcasSnapshot> start(dates.size());
+	for (size_t i=0; i<dates.size(); ) {
+		if (pre.ended || (pre.weather.date[pre.time] >= dates[i])) {
+			start[i] = pre.snapshot();
+			i++;
+		} else {
+			pre.step_day();
+		}
+	}
+	if (pre.fatalError) {
+		messages = pre.messages;
+		return false;
+	}
+
+	// continue with each schedule
+	messages = pre.messages;
+	std::vector<double> keys(n);
+	for (size_t i=0; i<n; i++) keys[i] = i + 1;
+	return LC_runs(pre, "schedule", keys, nthreads, [&](size_t i, LINcasModel &m) {
+		m.management.FERTAB = schedules[i];
+		if (!m.start()) return false;
+		size_t j = std::lower_bound(dates.begin(), dates.end(), first[i]) - dates.begin();
+		m.restore(start[j]);
+		return true;
+	}, out, messages);
+}
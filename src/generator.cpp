@@ -0,0 +1,305 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+
+Stochastic daily weather generator (after Richardson, 1981). The generated 
+weather is not stored; it is computed day by day in weather_step()
+*/
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include "LINTcas.h"
+
+
+// the matrices of the multivariate lag-1 model of the residuals 
+// (Matalas, 1967): A = M1 M0^-1, and B B' = M0 - A M1'. If M0 cannot be 
+// inverted, the residuals are not autocorrelated (A = 0)
+static void coefficients(const double M0[][LINcasWeatherGenerator::nvars], const double M1[][LINcasWeatherGenerator::nvars], double A[][LINcasWeatherGenerator::nvars], double B[][LINcasWeatherGenerator::nvars]) {
+	const int n = LINcasWeatherGenerator::nvars;
+	// M0^-1 with Gauss-Jordan elimination
+	double a[n][2*n];
+	for (int i=0; i<n; i++) {
+		for (int j=0; j<n; j++) {
+			a[i][j] = M0[i][j];
+			a[i][n+j] = (i == j) ? 1 : 0;
+		}
+	}
+	bool singular = false;
+	for (int c=0; c<n; c++) {
+		int p = c;
+		for (int i=c+1; i<n; i++) {
+			if (std::fabs(a[i][c]) > std::fabs(a[p][c])) p = i;
+		}
+		if (std::fabs(a[p][c]) < 1e-10) {
+			singular = true;
+			break;
+		}
+		for (int j=0; j<2*n; j++) std::swap(a[c][j], a[p][j]);
+		double f = a[c][c];
+		for (int j=0; j<2*n; j++) a[c][j] /= f;
+		for (int i=0; i<n; i++) {
+			if (i == c) continue;
+			f = a[i][c];
+			for (int j=0; j<2*n; j++) a[i][j] -= f * a[c][j];
+		}
+	}
+	double C[n][n];
+	for (int i=0; i<n; i++) {
+		for (int j=0; j<n; j++) {
+			A[i][j] = 0;
+			if (!singular) {
+				for (int k=0; k<n; k++) A[i][j] += M1[i][k] * a[k][n+j];
+			}
+		}
+	}
+	for (int i=0; i<n; i++) {
+		for (int j=0; j<n; j++) {
+			C[i][j] = M0[i][j];
+			for (int k=0; k<n; k++) C[i][j] -= A[i][k] * M1[j][k];
+		}
+	}
+	// B is the Cholesky factor of C. A pivot that is not positive (C is not 
+	// positive definite because of sampling error) is set to zero
+	for (int i=0; i<n; i++) {
+		for (int j=0; j<n; j++) {
+			B[i][j] = 0;
+			if (j > i) continue;
+			double x = C[i][j];
+			for (int k=0; k<j; k++) x -= B[i][k] * B[j][k];
+			if (i == j) {
+				B[i][j] = x > 0 ? std::sqrt(x) : 0;
+			} else if (B[j][j] > 0) {
+				B[i][j] = x / B[j][j];
+			}
+		}
+	}
+}
+
+
+bool LINcasWeatherGenerator::fit(const LINcasWeatherData &w, std::string &msg) {
+	size_t n = w.date.size();
+	if (n < 365) {
+		msg = "at least one year of weather data is needed to fit a weather generator";
+		return false;
+	}
+	const double wetday = 0.1; // mm
+	std::vector<int> month(n);
+	std::vector<int> wet(n);
+	for (size_t i=0; i<n; i++) {
+		month[i] = LC_month(w.date[i]);
+		wet[i] = w.prec[i] >= wetday;
+	}
+	const std::vector<double>* v[nvars] = {&w.tmin, &w.tmax, &w.srad, &w.vapr, &w.wind};
+
+	// precipitation occurrence and amounts
+	double nd[12]={0}, ndw[12]={0}, nw[12]={0}, nww[12]={0};
+	for (size_t i=1; i<n; i++) {
+		if (w.date[i] != (w.date[i-1] + 1)) continue;
+		int m = month[i];
+		if (wet[i-1]) {
+			nw[m]++;
+			nww[m] += wet[i];
+		} else {
+			nd[m]++;
+			ndw[m] += wet[i];
+		}
+	}
+	double cnt[12]={0}, s1[12]={0}, s2[12]={0};
+	for (size_t i=0; i<n; i++) {
+		if (!wet[i]) continue;
+		cnt[month[i]]++;
+		s1[month[i]] += w.prec[i];
+		s2[month[i]] += w.prec[i] * w.prec[i];
+	}
+	for (int m=0; m<12; m++) {
+		pwd[m] = nd[m] > 0 ? ndw[m] / nd[m] : 0;
+		pww[m] = nw[m] > 0 ? nww[m] / nw[m] : pwd[m];
+		shape[m] = 1;
+		scale[m] = 1;
+		if (cnt[m] > 0) {
+			double mn = s1[m] / cnt[m];
+			double var = s2[m] / cnt[m] - mn * mn;
+			if ((cnt[m] > 1) && (var > 0)) {
+				shape[m] = mn * mn / var;
+				scale[m] = var / mn;
+			} else {
+				scale[m] = mn;
+			}
+		}
+	}
+
+	// the other variables by month and dry/wet. The monthly values are used 
+	// if there are too few dry or wet days
+	double c[12][2]={{0}}, a[12][2][nvars]={}, b[12][2][nvars]={};
+	for (size_t i=0; i<n; i++) {
+		int m = month[i], k = wet[i];
+		c[m][k]++;
+		for (int j=0; j<nvars; j++) {
+			double x = (*v[j])[i];
+			a[m][k][j] += x;
+			b[m][k][j] += x * x;
+		}
+	}
+	for (int m=0; m<12; m++) {
+		double cm = c[m][0] + c[m][1];
+		if (cm < 2) {
+			msg = "the weather data do not cover all months";
+			return false;
+		}
+		for (int j=0; j<nvars; j++) {
+			for (int k=0; k<2; k++) {
+				double cc = c[m][k], aa = a[m][k][j], bb = b[m][k][j];
+				if (cc < 2) {
+					cc = cm;
+					aa = a[m][0][j] + a[m][1][j];
+					bb = b[m][0][j] + b[m][1][j];
+				}
+				mean[m][k][j] = aa / cc;
+				sd[m][k][j] = std::sqrt(std::max(0., bb / cc - mean[m][k][j] * mean[m][k][j]));
+			}
+		}
+	}
+
+	// lag-0 (M0) and lag-1 (M1) correlations of the standardized residuals
+	std::vector<std::array<double, nvars>> r(n);
+	for (size_t i=0; i<n; i++) {
+		for (int j=0; j<nvars; j++) {
+			double s = sd[month[i]][wet[i]][j];
+			r[i][j] = s > 0 ? ((*v[j])[i] - mean[month[i]][wet[i]][j]) / s : 0;
+		}
+	}
+	double M0[nvars][nvars]={}, M1[nvars][nvars]={};
+	size_t n1 = 0;
+	for (size_t i=0; i<n; i++) {
+		for (int j=0; j<nvars; j++) {
+			for (int k=0; k<nvars; k++) M0[j][k] += r[i][j] * r[i][k];
+		}
+		if ((i == 0) || (w.date[i] != (w.date[i-1] + 1))) continue;
+		n1++;
+		for (int j=0; j<nvars; j++) {
+			for (int k=0; k<nvars; k++) M1[j][k] += r[i][j] * r[i-1][k];
+		}
+	}
+	double s0[nvars];
+	for (int j=0; j<nvars; j++) {
+		s0[j] = M0[j][j] > 0 ? std::sqrt(M0[j][j] / n) : 0;
+	}
+	for (int j=0; j<nvars; j++) {
+		for (int k=0; k<nvars; k++) {
+			double sjk = s0[j] * s0[k];
+			M0[j][k] = (j == k) ? 1 : (sjk > 0 ? M0[j][k] / (n * sjk) : 0);
+			M1[j][k] = ((n1 > 0) && (sjk > 0)) ? M1[j][k] / (n1 * sjk) : 0;
+		}
+	}
+	coefficients(M0, M1, A, B);
+	return true;
+}
+
+
+// The distributions are sampled from the raw output of the generator (and 
+// not with those of the standard library, that are implementation defined), 
+// such that the weather is the same on all platforms.
+
+// uniform on [0, 1), with 53 random bits
+static double sampleUniform(std::mt19937_64 &rng) {
+	return (rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// standard normal (Box-Muller)
+static double sampleNormal(std::mt19937_64 &rng) {
+	double u = 1 - sampleUniform(rng);
+	double v = sampleUniform(rng);
+	return std::sqrt(-2 * std::log(u)) * std::cos(6.283185307179586 * v);
+}
+
+// gamma (Marsaglia and Tsang, 2000). For a shape below one, a sample of 
+// shape + 1 is multiplied by U^(1/shape)
+static double sampleGamma(std::mt19937_64 &rng, double shape, double scale) {
+	if (shape < 1) {
+		double u = 1 - sampleUniform(rng);
+		return sampleGamma(rng, shape + 1, scale) * std::pow(u, 1 / shape);
+	}
+	double d = shape - 1.0 / 3;
+	double c = 1 / std::sqrt(9 * d);
+	while (true) {
+		double x, v;
+		do {
+			x = sampleNormal(rng);
+			v = 1 + c * x;
+		} while (v <= 0);
+		v = v * v * v;
+		double u = 1 - sampleUniform(rng);
+		if (std::log(u) < (0.5 * x * x + d - d * v + d * std::log(v))) {
+			return d * v * scale;
+		}
+	}
+}
+
+
+void LINcasGeneratorState::seed(uint64_t s) {
+	std::seed_seq seq{uint32_t(s), uint32_t(s >> 32)};
+	rng.seed(seq);
+	wet = false;
+	std::fill(z, z + LINcasWeatherGenerator::nvars, 0.);
+}
+
+std::string LINcasGeneratorState::str() const {
+	std::ostringstream os;
+	os.precision(17);
+	os << rng << ' ' << wet;
+	for (int j=0; j<LINcasWeatherGenerator::nvars; j++) {
+		os << ' ' << z[j];
+	}
+	return os.str();
+}
+
+bool LINcasGeneratorState::set(const std::string &s) {
+	std::istringstream is(s);
+	is >> rng >> wet;
+	for (int j=0; j<LINcasWeatherGenerator::nvars; j++) {
+		is >> z[j];
+	}
+	return !is.fail();
+}
+
+void LINcasGeneratorState::next(const LINcasWeatherGenerator &g, long date, LINcasDay &d) {
+	const int n = LINcasWeatherGenerator::nvars;
+	int m = LC_month(date);
+	wet = sampleUniform(rng) < (wet ? g.pww[m] : g.pwd[m]);
+	d.prec = wet ? sampleGamma(rng, g.shape[m], g.scale[m]) : 0;
+	double e[n], zt[n], x[n];
+	for (int j=0; j<n; j++) {
+		e[j] = sampleNormal(rng);
+	}
+	for (int j=0; j<n; j++) {
+		zt[j] = 0;
+		for (int k=0; k<n; k++) {
+			zt[j] += g.A[j][k] * z[k] + g.B[j][k] * e[k];
+		}
+	}
+	for (int j=0; j<n; j++) {
+		z[j] = zt[j];
+		x[j] = g.mean[m][wet][j] + g.sd[m][wet][j] * z[j];
+	}
+	d.tmin = x[0];
+	d.tmax = std::max(x[0], x[1]);
+	d.srad = std::max(0., x[2]);
+	d.vapr = std::max(0., x[3]);
+	d.wind = std::max(0., x[4]);
+}
+
+
+// Run the model with n generated weather sequences (with seeds seed, seed+1, ...) 
+// for the dates of the weather of the base model. 
+// The output has the states at harvest for each sequence
+bool LC_stochastic_runs(const LINcasModel &base, std::shared_ptr<const LINcasWeatherGenerator> g, size_t n, uint64_t seed, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages) {
+	std::vector<double> keys(n);
+	for (size_t i=0; i<n; i++) keys[i] = i + 1;
+	return LC_runs(base, "member", keys, nthreads, [&](size_t i, LINcasModel &m) {
+		m.weather.generator = g;
+		m.weather.seed = seed + i;
+		return m.start();
+	}, out, messages);
+}
@@ -0,0 +1,325 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "LINTcas.h"
+#include "parallel.h"
+
+
+// the state variables for the output of a grid run
+static bool outputStates(const LINcasModel &base, const std::vector<std::string> &vars, std::vector<double LINcasVariables::*> &states, std::vector<std::string> &messages) {
+	for (const std::string &s : vars) {
+		int k = LC_variable_index(s.c_str());
+		if ((k < 0) || (LC_variables()[k].npk && !base.control.NPKmodel)) {
+			messages.push_back("unknown output variable: " + s);
+			return false;
+		}
+		states.push_back(LC_variables()[k].value);
+	}
+	return true;
+}
+
+
+// Run the model for each cell of a grid. The crop parameters and the dates are
+// those of base; the parameters in "index" have a value for each cell (e.g. soil
+// parameters). Cells with mask == 0 or with missing weather on any day are 
+// skipped. The cells are processed in tiles of "tile" cells: the weather of
+// a tile is first copied to a buffer in which the series of each cell are
+// contiguous. done(cell, thread, model) is called for each cell that was
+// simulated without error
+template <class F>
+static bool gridCells(const LINcasModel &base, const LINcasWeatherCube &weather, const std::vector<int> &index, const std::vector<std::vector<double>> &values, const std::vector<int> &mask, size_t tile, size_t nthreads, F done, std::vector<std::string> &messages) {
+
+	size_t ncells = weather.ncells;
+	size_t nd = weather.date.size();
+	if ((ncells == 0) || (nd == 0)) {
+		messages.push_back("no weather data");
+		return false;
+	}
+	if ((!mask.empty()) && (mask.size() != ncells)) {
+		messages.push_back("the mask does not have a value for each cell");
+		return false;
+	}
+	for (const std::vector<double> &v : values) {
+		if (v.size() != ncells) {
+			messages.push_back("the parameters do not have a value for each cell");
+			return false;
+		}
+	}
+
+	tile = std::max(size_t(1), tile);
+	size_t ntiles = (ncells + tile - 1) / tile;
+	std::vector<std::vector<double>> buffers(std::max(size_t(1), nthreads), std::vector<double>(6 * tile * nd));
+	std::vector<LINcasModel> pool(buffers.size());
+	std::vector<LINcasOverlay> overlays(buffers.size());
+	for (LINcasOverlay &ov : overlays) {
+		for (int k : index) ov.values.push_back({k, 0});
+	}
+	std::vector<size_t> failed(ntiles, 0);
+	std::vector<std::string> msgs(ntiles);
+
+	LC_parallel(ntiles, nthreads, [&](size_t i, size_t t) {
+		size_t first = i * tile;
+		size_t n = std::min(tile, ncells - first);
+		std::vector<double> &b = buffers[t];
+		// b[var][cell][day]
+		for (size_t v=0; v<6; v++) {
+			for (size_t d=0; d<nd; d++) {
+				for (size_t c=0; c<n; c++) {
+					b[(v * tile + c) * nd + d] = weather.get(first + c, d, v);
+				}
+			}
+		}
+		LINcasModel &m = pool[t];
+		LINcasOverlay &ov = overlays[t];
+		for (size_t c=0; c<n; c++) {
+			size_t cell = first + c;
+			if ((!mask.empty()) && (mask[cell] == 0)) continue;
+			bool nodata = false;
+			for (size_t v=0; (v<6) && (!nodata); v++) {
+				const double* x = &b[(v * tile + c) * nd];
+				nodata = std::any_of(x, x + nd, [](double y) { return std::isnan(y); });
+			}
+			if (nodata) continue;
+
+			for (size_t j=0; j<values.size(); j++) {
+				ov.values[j].second = values[j][cell];
+			}
+			ov.apply(base, m);
+			m.weather.data = nullptr;
+			m.weather.generator = nullptr;
+			m.weather.date = LINcasSpan<long>(weather.date);
+			m.weather.srad = LINcasSpan<double>(&b[(0 * tile + c) * nd], nd);
+			m.weather.tmin = LINcasSpan<double>(&b[(1 * tile + c) * nd], nd);
+			m.weather.tmax = LINcasSpan<double>(&b[(2 * tile + c) * nd], nd);
+			m.weather.prec = LINcasSpan<double>(&b[(3 * tile + c) * nd], nd);
+			m.weather.wind = LINcasSpan<double>(&b[(4 * tile + c) * nd], nd);
+			m.weather.vapr = LINcasSpan<double>(&b[(5 * tile + c) * nd], nd);
+			m.control.outvars = "batch";
+			m.management.harvests.clear();
+			m.reset();
+			if (m.start()) {
+				while (m.step_day()) {}
+			}
+			if (m.fatalError) {
+				if (failed[i] == 0) msgs[i] = m.messages.empty() ? "" : m.messages.back();
+				failed[i]++;
+				continue;
+			}
+			done(cell, t, m);
+		}
+	});
+
+	size_t nfailed = 0;
+	for (size_t i=0; i<ntiles; i++) {
+		if ((nfailed == 0) && (failed[i] > 0)) {
+			messages.push_back(msgs[i]);
+		}
+		nfailed += failed[i];
+	}
+	if (nfailed > 0) {
+		messages.push_back(std::to_string(nfailed) + " cell(s) could not be simulated");
+	}
+	return true;
+}
+
+
+// The output has the states at harvest of "vars" for each cell (NAN for
+// skipped cells), with the cells varying fastest
+bool LC_grid_run(const LINcasModel &base, const LINcasWeatherCube &weather, const std::vector<int> &index, const std::vector<std::vector<double>> &values, const std::vector<int> &mask, const std::vector<std::string> &vars, size_t tile, size_t nthreads, std::vector<double> &out, std::vector<std::string> &messages) {
+
+	std::vector<double LINcasVariables::*> states;
+	if (!outputStates(base, vars, states, messages)) return false;
+	size_t ncells = weather.ncells;
+	out.assign(ncells * vars.size(), NAN);
+	return gridCells(base, weather, index, values, mask, tile, nthreads, [&](size_t cell, size_t, const LINcasModel &m) {
+		for (size_t j=0; j<states.size(); j++) {
+			out[j * ncells + cell] = m.S.*states[j];
+		}
+	}, messages);
+}
+
+
+// The weighted statistics of a variable in a zone. The quantiles are estimated
+// with a small merging digest: a list of centroids (mean and weight). When 
+// there are more than "size" of them, neighbouring centroids are merged into 
+// about size/2 centroids, that are smaller near the tails. The quantiles are 
+// exact as long as nothing was merged, and the error is otherwise well below 
+// 1% for all but the most extreme quantiles. A digest has at most 3.2 KB, 
+// whatever the number of cells in the zone
+class ZoneStats {
+public:
+	double w=0, wx=0;
+	double xmin=INFINITY, xmax=-INFINITY;
+	bool merged=false; // if false, each centroid is a value
+	std::vector<std::pair<double, double>> c; // centroids: mean, weight
+	static constexpr size_t size = 200;
+
+	void add(double x, double weight) {
+		w += weight;
+		wx += weight * x;
+		xmin = std::min(xmin, x);
+		xmax = std::max(xmax, x);
+		c.push_back({x, weight});
+		if (c.size() > size) compress();
+	}
+	void merge(const ZoneStats &z) {
+		w += z.w;
+		wx += z.wx;
+		xmin = std::min(xmin, z.xmin);
+		xmax = std::max(xmax, z.xmax);
+		merged = merged || z.merged;
+		c.insert(c.end(), z.c.begin(), z.c.end());
+		if (c.size() > size) compress();
+	}
+	// the scale function of the merging: a centroid can span one unit of 
+	// k(q), that is smaller near the tails
+	static double k(double q) {
+		return size / (2 * M_PI) * std::asin(2 * std::min(1., q) - 1);
+	}
+	void compress() {
+		std::sort(c.begin(), c.end());
+		size_t n = 0;
+		double cum = 0, k0 = k(0);
+		for (size_t i=1; i<c.size(); i++) {
+			std::pair<double, double> &a = c[n];
+			if ((k((cum + a.second + c[i].second) / w) - k0) <= 1) {
+				a.first += (c[i].first - a.first) * c[i].second / (a.second + c[i].second);
+				a.second += c[i].second;
+				merged = true;
+			} else {
+				cum += a.second;
+				k0 = k(cum / w);
+				c[++n] = c[i];
+			}
+		}
+		c.resize(std::min(c.size(), n + 1));
+	}
+	// the smallest value with a cumulative weight of at least p*w. After 
+	// merging, this is interpolated between the centers of the centroids
+	double quantile(double p) {
+		if (c.empty()) return NAN;
+		std::sort(c.begin(), c.end());
+		double target = p * w;
+		double cum = 0;
+		if (!merged) {
+			for (const std::pair<double, double> &x : c) {
+				cum += x.second;
+				if (cum >= target) return x.first;
+			}
+			return c.back().first;
+		}
+		double x0 = xmin, q0 = 0;
+		for (const std::pair<double, double> &x : c) {
+			double q1 = cum + x.second / 2;
+			if (q1 >= target) {
+				return x0 + (x.first - x0) * (target - q0) / (q1 - q0);
+			}
+			x0 = x.first;
+			q0 = q1;
+			cum += x.second;
+		}
+		return x0 + (xmax - x0) * (target - q0) / (w - q0);
+	}
+};
+
+
+// A grid run of which the output is aggregated by zone. Each thread has its own
+// statistics for each zone, which are merged at the end, such that the output
+// of the cells is not stored. Cells without a zone (id < 0) or with a weight
+// that is not positive are not simulated. The output has a row for each zone
+// with the number of cells, the sum of the weights, and for each variable the
+// weighted mean, the weighted total (the sum of weight times value) and the
+// weighted quantiles
+bool LC_grid_zonal(const LINcasModel &base, const LINcasWeatherCube &weather, const std::vector<int> &index, const std::vector<std::vector<double>> &values, const std::vector<int> &mask, const std::vector<std::string> &vars, const LINcasZones &zones, size_t tile, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages) {
+
+	std::vector<double LINcasVariables::*> states;
+	if (!outputStates(base, vars, states, messages)) return false;
+	size_t ncells = weather.ncells;
+	if ((zones.id.size() != ncells) || ((!zones.weight.empty()) && (zones.weight.size() != ncells))) {
+		messages.push_back("the zones and weights must have a value for each cell");
+		return false;
+	}
+	for (double p : zones.probs) {
+		if (!((p >= 0) && (p <= 1))) {
+			messages.push_back("probabilities must be between 0 and 1");
+			return false;
+		}
+	}
+
+	// the zone ids in order, and the index of the zone of each cell
+	std::vector<int> ids;
+	for (int z : zones.id) {
+		if (z >= 0) ids.push_back(z);
+	}
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+	std::vector<int> zone(ncells, -1);
+	std::vector<int> run(ncells, 0);
+	for (size_t i=0; i<ncells; i++) {
+		if (zones.id[i] < 0) continue;
+		double w = zones.weight.empty() ? 1 : zones.weight[i];
+		if (!(w > 0)) continue;
+		if ((!mask.empty()) && (mask[i] == 0)) continue;
+		zone[i] = std::lower_bound(ids.begin(), ids.end(), zones.id[i]) - ids.begin();
+		run[i] = 1;
+	}
+
+	size_t nv = vars.size();
+	size_t nt = std::max(size_t(1), nthreads);
+	std::vector<std::vector<ZoneStats>> stats(nt, std::vector<ZoneStats>(ids.size() * nv));
+	// the number of cells and the sum of their weights
+	std::vector<std::vector<double>> cells(nt, std::vector<double>(ids.size(), 0));
+	std::vector<std::vector<double>> weights(nt, std::vector<double>(ids.size(), 0));
+	bool ok = gridCells(base, weather, index, values, run, tile, nthreads, [&](size_t cell, size_t t, const LINcasModel &m) {
+		double w = zones.weight.empty() ? 1 : zones.weight[cell];
+		cells[t][zone[cell]]++;
+		weights[t][zone[cell]] += w;
+		ZoneStats* z = &stats[t][zone[cell] * nv];
+		for (size_t j=0; j<nv; j++) {
+			double x = m.S.*states[j];
+			if (!std::isnan(x)) z[j].add(x, w);
+		}
+	}, messages);
+	if (!ok) return false;
+
+	for (size_t t=1; t<nt; t++) {
+		for (size_t k=0; k<stats[0].size(); k++) {
+			stats[0][k].merge(stats[t][k]);
+		}
+		for (size_t k=0; k<ids.size(); k++) {
+			cells[0][k] += cells[t][k];
+			weights[0][k] += weights[t][k];
+		}
+	}
+
+	out.names = {"zone", "cells", "weight"};
+	for (const std::string &v : vars) {
+		out.names.push_back(v + "_mean");
+		out.names.push_back(v + "_total");
+		for (double p : zones.probs) {
+			char q[32];
+			snprintf(q, sizeof(q), "_q%g", 100 * p);
+			out.names.push_back(v + q);
+		}
+	}
+	out.values.clear();
+	out.values.reserve(ids.size() * out.names.size());
+	for (size_t i=0; i<ids.size(); i++) {
+		ZoneStats* z = &stats[0][i * nv];
+		out.values.insert(out.values.end(), {double(ids[i]), cells[0][i], weights[0][i]});
+		for (size_t j=0; j<nv; j++) {
+			out.values.push_back(z[j].w > 0 ? z[j].wx / z[j].w : NAN);
+			out.values.push_back(z[j].wx);
+			for (double p : zones.probs) {
+				out.values.push_back(z[j].quantile(p));
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,23 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include "LINTcas.h"
+
+
+// Deficit irrigation strategies (IRRFRAC, IRRAMOUNT, IRRMAX; see drunir) of a 
+// water limited model. The output has the states at harvest for each strategy
+bool LC_irrigation_sweep(const LINcasModel &base, const std::vector<std::array<double, 3>> &strategies, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages) {
+
+	std::vector<double> keys(strategies.size());
+	for (size_t i=0; i<keys.size(); i++) keys[i] = i + 1;
+	return LC_runs(base, "strategy", keys, nthreads, [&](size_t i, LINcasModel &m) {
+		m.control.water_limited = true;
+		m.management.IRRFRAC = strategies[i][0];
+		m.management.IRRAMOUNT = strategies[i][1];
+		m.management.IRRMAX = strategies[i][2];
+		return m.start();
+	}, out, messages);
+}
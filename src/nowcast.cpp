@@ -0,0 +1,87 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <algorithm>
+#include "LINTcas.h"
+
+
+// Simulate up to and including "today" with weather "w". The days that were 
+// simulated before with the same weather (and parameters) are not simulated again
+bool LINcasNowcast::update(std::shared_ptr<const LINcasWeatherData> w, long today, std::string &msg) {
+	LINcasModel &m = model;
+	simulated = 0;
+	if (m.control.outvars == "batch") {
+		msg = "batch output cannot be used for nowcasting";
+		return false;
+	}
+	if (m.multipleHarvests() && m.control.NPKmodel) {
+		msg = "cannot nowcast an NPK model with multiple harvest dates";
+		return false;
+	}
+	m.weather.set(w);
+	const long* it = std::find(m.weather.date.begin(), m.weather.date.end(), m.control.modelstart);
+	if (it == m.weather.date.end()) {
+		msg = "the start date is not in the weather data";
+		return false;
+	}
+	size_t time0 = it - m.weather.date.begin();
+
+	uint64_t phash = m.parameterHash();
+	size_t first = 0; // the first day with different weather
+	if (phash == parameters) {
+		size_t n = std::min(days.size(), m.weather.date.size() - time0);
+		while ((first < n) && (days[first] == m.weatherHash(time0 + first, time0 + first + 1))) {
+			first++;
+		}
+	}
+	if (points.empty() || (first == 0)) {
+		m.reset();
+		if (!m.start(true)) {
+			msg = m.messages.empty() ? "cannot start the model" : m.messages.back();
+			points.clear();
+			days.clear();
+			return false;
+		}
+		parameters = phash;
+		points.clear();
+		days.clear();
+	} else if (first == days.size()) {
+		// the weather was extended; continue from the current state
+		m.time = m.time - start + time0;
+	} else {
+		size_t j = std::min(size_t(first / interval), points.size() - 1);
+		points.resize(j+1);
+		days.resize(j * interval);
+		LINcasSnapshot x = points[j].x;
+		x.time += time0;
+		m.restore(x);
+		m.out.values.resize(points[j].nout);
+		m.messages.resize(points[j].nmsg);
+		m.fatalError = false;
+	}
+	start = time0;
+
+	while ((!m.ended) && (m.time < m.weather.date.size()) && (m.weather.date[m.time] <= today)) {
+		size_t day = m.time - time0;
+		if (((day % interval) == 0) && ((day / interval) == points.size())) {
+			Point p;
+			p.x = m.snapshot();
+			p.x.time = day;
+			p.nout = m.out.values.size();
+			p.nmsg = m.messages.size();
+			points.push_back(p);
+		}
+		// steps do not go beyond today or the next snapshot
+		long until = std::min(today, m.weather.date[time0] + long(points.size() * interval) - 1);
+		unsigned n = m.step_length(until);
+		for (unsigned i=0; i<n; i++) {
+			days.push_back(m.weatherHash(m.time + i, m.time + i + 1));
+		}
+		m.step_day(until);
+		simulated += n;
+	}
+	return true;
+}
@@ -33,7 +33,7 @@ inline double Mirrored_Monod(double x, double K, double Kmax) {
 
     
 
-std::vector<double> LINcasModel::npkical(
+std::array<double, 4> LINcasModel::npkical(
 		double NMINLV, double PMINLV, double KMINLV,
 		double NMINST, double PMINST, double KMINST, 
 		double NMINSO, double PMINSO, double KMINSO, 
@@ -77,7 +77,16 @@ std::vector<double> LINcasModel::npkical(
 	//The "Monod" acts as scalar to reduce effect of minor deficiencies that do not affect growth rates but are compensated by dilution. A mirrored Monod function to determine effect of N, P and K stress on NPKI 
 	double NPKI = Mirrored_Monod(NNI*PNI*KNI, crop.K_NPK_NI, crop.K_MAX);
   
-	return std::vector<double> {NNI, PNI, KNI, NPKI};
+	return std::array<double, 4> {NNI, PNI, KNI, NPKI};
+}
+
+
+// A warning for the first day with an unbalanced internal reallocation of 
+// nutrient k (N, P, K), such that the days after that do not allocate memory
+static void unbalanced(LINcasModel &m, unsigned k, const char* el) {
+	if (m.unreliable & (1 << k)) return;
+	m.unreliable |= 1 << k;
+	m.messages.push_back(std::string("UNRELIABLE RESULTS!! Internal ") + el + " reallocation must be net 0 (first on day " + std::to_string(m.step) + ")");
 }
 
 
@@ -93,13 +102,18 @@ void LINcasModel::nutrientdyn(bool EMERG,
     //---------------- Fertilizer application;
 	// Fertilizer N/P/K application (kg N/P/K ha-1 d-1)
 	double RFERTN = 0, RFERTP = 0, RFERTK = 0;
-    auto it = std::find(management.FERTAB[0].begin(), management.FERTAB[0].end(), A.date);
-    if (it != management.FERTAB[0].end()) {
-		size_t i = std::distance(management.FERTAB[0].begin(), it);
-		RFERTN = management.FERTAB[1][i] * crop.N_RECOV / 10; // kg ha-1 to g m-2 
-		RFERTP = management.FERTAB[2][i] * crop.P_RECOV / 10; // kg ha-1 to g m-2 
-		RFERTK = management.FERTAB[3][i] * crop.K_RECOV / 10; // kg ha-1 to g m-2 
+	for (unsigned d=0; d<DELT; d++) {
+		int i = calendar.fertrow(A.date + d);
+		if (i >= 0) {
+			RFERTN += management.FERTAB[1][i] * crop.N_RECOV / 10; // kg ha-1 to g m-2 
+			RFERTP += management.FERTAB[2][i] * crop.P_RECOV / 10; // kg ha-1 to g m-2 
+			RFERTK += management.FERTAB[3][i] * crop.K_RECOV / 10; // kg ha-1 to g m-2 
+		}
 	}
+	// the amount applied in a time step of more than one day, as a daily rate
+	RFERTN /= DELT;
+	RFERTP /= DELT;
+	RFERTK /= DELT;
 
 	//---------------- Translocatable nutrient amounts;
 	// The amount of translocatable nutrients to the storage organs is the actual nutrient amount minus the ;
@@ -172,16 +186,13 @@ void LINcasModel::nutrientdyn(bool EMERG,
 	//---------------;
 	double TINY = 1e-08;
 	if (abs(RNTLV + RNTST + RNTSO + RNTRT) > TINY) {
-		Rcpp::Rcout << "UNRELIABLE RESULTS!! Internal N reallocation must be net 0\n";
-		Rcpp::Rcout << RNTLV << " " << RNTST << " " << RNTSO << " " << RNTRT << std::endl;
+		unbalanced(*this, 0, "N");
 	}
 	if (abs(RPTLV + RPTST + RPTSO + RPTRT) > TINY) {
-		Rcpp::Rcout << "UNRELIABLE RESULTS!! Internal P reallocation must be net 0\n";
-		Rcpp::Rcout << RPTLV << " " << RPTST << " " << RPTSO << " " << RPTRT << std::endl;
+		unbalanced(*this, 1, "P");
 	}
 	if (abs(RKTLV + RKTST + RKTSO + RKTRT) > TINY) {
-		Rcpp::Rcout << "UNRELIABLE RESULTS!! Internal K reallocation must be net 0\n";
-		Rcpp::Rcout << RKTLV << " " << RKTST << " " << RKTSO << " " << RKTRT << std::endl;
+		unbalanced(*this, 2, "K");
 	}
 
 	//--------------- Nutrient uptake;
@@ -205,7 +216,7 @@ void LINcasModel::nutrientdyn(bool EMERG,
 	//uptake rates increase when soil supply is larger. Interaction effects are not accounted for here. 
 	//If uptake isn't adequate, concentrations will decrease first, later growth rates decrease.
 	//gNEQ m-2 d-1     g m-2           d-1,       d-1                              g m-2
-	double RMAX_UPRATE = std::min(NUTEQ_DEMAND/control.DELT, crop.SLOPE_NEQ_SOILSUPPLY_NEQ_PLANTUPTAKE * NUTEQ_SOIL);
+	double RMAX_UPRATE = std::min(NUTEQ_DEMAND/DELT, crop.SLOPE_NEQ_SOILSUPPLY_NEQ_PLANTUPTAKE * NUTEQ_SOIL);
 
 	//If actual ratios are suboptimal, uptake of excess nutrients is relatively increased.
 	//A suboptimal ratio in the soil results in a suboptimal ratio in the plant when supply is smaller than demand.
@@ -222,9 +233,9 @@ void LINcasModel::nutrientdyn(bool EMERG,
 
 	//Actual uptake is limited by demand based on std::maximum concentrations for standing biomass
 	//Uptake rate should not exceed std::maximum soil supply.
-	RNUPTR = std::min(S.NMINT/control.DELT, std::min(RNUPTR, NDEMTO/control.DELT));
-	RPUPTR = std::min(S.PMINT/control.DELT, std::min(RPUPTR, PDEMTO/control.DELT));
-	RKUPTR = std::min(S.KMINT/control.DELT, std::min(RKUPTR, KDEMTO/control.DELT));
+	RNUPTR = std::min(S.NMINT/DELT, std::min(RNUPTR, NDEMTO/DELT));
+	RPUPTR = std::min(S.PMINT/DELT, std::min(RPUPTR, PDEMTO/DELT));
+	RKUPTR = std::min(S.KMINT/DELT, std::min(RKUPTR, KDEMTO/DELT));
 
 	//------------- Partitioning;
 	// to compute the partitioning of the total N/P/K uptake rates (NUPTR, PUPTR, KUPTR);
@@ -323,9 +334,9 @@ void LINcasModel::nutrientdyn(bool EMERG,
 	//The reason for this is that soil supply isn't modelled but a given from control plots. 
 	//With unknown number of days with water limitations it is impossible to know the potential uptake rate from this pool.
 	// Rate of the nutrient amount which becomes available due to soil mineralization.  
-	R.NMINS = S.NMINS < soil.RTNMINS ? -S.NMINS/control.DELT : -soil.RTNMINS; // g N m-2 d-1
-	R.PMINS = S.NMINS < soil.RTPMINS ? -S.PMINS/control.DELT : -soil.RTPMINS; // g P m-2 d-1
-	R.KMINS = S.NMINS < soil.RTKMINS ? -S.KMINS/control.DELT : -soil.RTKMINS; // g K m-2 d-1
+	R.NMINS = S.NMINS < soil.RTNMINS ? -S.NMINS/DELT : -soil.RTNMINS; // g N m-2 d-1
+	R.PMINS = S.NMINS < soil.RTPMINS ? -S.PMINS/DELT : -soil.RTPMINS; // g P m-2 d-1
+	R.KMINS = S.NMINS < soil.RTKMINS ? -S.KMINS/DELT : -soil.RTKMINS; // g K m-2 d-1
   
 	//------------ Fertilizer supply
 	//Fertilizer nutrient supply 
@@ -0,0 +1,229 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+#include "LINTcas.h"
+#include "outputfile.h"
+
+static const char magic[8] = {'L', 'I', 'N', 'C', 'A', 'S', 'O', '1'};
+
+// files can be larger than 2 GB
+static int seek(FILE* f, int64_t pos, int whence) {
+#ifdef _WIN32
+	return _fseeki64(f, pos, whence);
+#else
+	return fseeko(f, off_t(pos), whence);
+#endif
+}
+
+
+LINcasOutputFile::~LINcasOutputFile() {
+	if (f != nullptr) {
+		std::string msg;
+		close(msg);
+	}
+}
+
+
+bool LINcasOutputFile::create(const std::string &filename, std::string &msg) {
+	if (f != nullptr) {
+		msg = "the output file is already open";
+		return false;
+	}
+	f = std::fopen(filename.c_str(), "wb");
+	if (f == nullptr) {
+		msg = "cannot create " + filename;
+		return false;
+	}
+	writing = true;
+	names.clear();
+	index.clear();
+	end = sizeof(magic);
+	if ((std::fwrite(magic, 1, sizeof(magic), f) != sizeof(magic)) || (std::fflush(f) != 0)) {
+		msg = "cannot write to " + filename;
+		std::fclose(f);
+		f = nullptr;
+		writing = false;
+		return false;
+	}
+	return true;
+}
+
+
+bool LINcasOutputFile::write(size_t job, const std::string &name, const double* x, size_t n, size_t stride, std::string &msg) {
+	// shuffle and compress without holding the lock
+	size_t nb = n * sizeof(double);
+	std::vector<unsigned char> b(nb);
+	for (size_t i=0; i<n; i++) {
+		unsigned char v[sizeof(double)];
+		std::memcpy(v, &x[i * stride], sizeof(double));
+		for (size_t k=0; k<sizeof(double); k++) {
+			b[k * n + i] = v[k];
+		}
+	}
+	uLongf size = compressBound(nb);
+	std::vector<unsigned char> z(size);
+	if (compress2(z.data(), &size, b.data(), nb, Z_BEST_SPEED) != Z_OK) {
+		msg = "compression failed";
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mtx);
+	if (!writing) {
+		msg = "the output file is not open for writing";
+		return false;
+	}
+	size_t k = std::find(names.begin(), names.end(), name) - names.begin();
+	if (k == names.size()) names.push_back(name);
+	if (std::fwrite(z.data(), 1, size, f) != size) {
+		msg = "cannot write to the output file";
+		return false;
+	}
+	index.push_back({uint64_t(job), uint64_t(k), end, uint64_t(size), uint64_t(n)});
+	end += size;
+	return true;
+}
+
+
+bool LINcasOutputFile::write(size_t job, const LINcasOutput &out, std::string &msg) {
+	size_t nc = out.names.size();
+	size_t nr = (nc == 0) ? 0 : out.values.size() / nc;
+	for (size_t j=0; j<nc; j++) {
+		if (!write(job, out.names[j], out.values.data() + j, nr, nc, msg)) return false;
+	}
+	return true;
+}
+
+
+static bool writeNumber(FILE* f, uint64_t x) {
+	return std::fwrite(&x, sizeof(x), 1, f) == 1;
+}
+
+static bool readNumber(FILE* f, uint64_t &x) {
+	return std::fread(&x, sizeof(x), 1, f) == 1;
+}
+
+
+bool LINcasOutputFile::close(std::string &msg) {
+	std::lock_guard<std::mutex> lock(mtx);
+	if (f == nullptr) return true;
+	bool ok = true;
+	if (writing) {
+		ok = writeNumber(f, names.size());
+		for (const std::string &s : names) {
+			ok = ok && writeNumber(f, s.size()) && (std::fwrite(s.data(), 1, s.size(), f) == s.size());
+		}
+		ok = ok && writeNumber(f, index.size());
+		for (const Block &b : index) {
+			ok = ok && writeNumber(f, b.job) && writeNumber(f, b.column) && writeNumber(f, b.offset) && writeNumber(f, b.size) && writeNumber(f, b.n);
+		}
+		ok = ok && writeNumber(f, end) && (std::fwrite(magic, 1, sizeof(magic), f) == sizeof(magic));
+		writing = false;
+	}
+	ok = (std::fclose(f) == 0) && ok;
+	f = nullptr;
+	if (!ok) msg = "cannot write to the output file";
+	return ok;
+}
+
+
+bool LINcasOutputFile::open(const std::string &filename, std::string &msg) {
+	if (f != nullptr) {
+		msg = "the output file is already open";
+		return false;
+	}
+	f = std::fopen(filename.c_str(), "rb");
+	if (f == nullptr) {
+		msg = "cannot open " + filename;
+		return false;
+	}
+	writing = false;
+	char m[sizeof(magic)];
+	uint64_t pos, n;
+	bool ok = (std::fread(m, 1, sizeof(m), f) == sizeof(m)) && (std::memcmp(m, magic, sizeof(m)) == 0);
+	ok = ok && (seek(f, -int64_t(sizeof(magic) + sizeof(pos)), SEEK_END) == 0) && readNumber(f, pos);
+	ok = ok && (std::fread(m, 1, sizeof(m), f) == sizeof(m)) && (std::memcmp(m, magic, sizeof(m)) == 0);
+	ok = ok && (seek(f, int64_t(pos), SEEK_SET) == 0) && readNumber(f, n);
+	names.clear();
+	index.clear();
+	for (uint64_t i=0; ok && (i<n); i++) {
+		uint64_t len;
+		ok = readNumber(f, len) && (len < 10000);
+		if (ok) {
+			std::string s(len, ' ');
+			ok = std::fread(&s[0], 1, len, f) == len;
+			names.push_back(s);
+		}
+	}
+	ok = ok && readNumber(f, n);
+	for (uint64_t i=0; ok && (i<n); i++) {
+		Block b;
+		ok = readNumber(f, b.job) && readNumber(f, b.column) && readNumber(f, b.offset) && readNumber(f, b.size) && readNumber(f, b.n);
+		ok = ok && (b.column < names.size()) && ((b.offset + b.size) <= pos);
+		index.push_back(b);
+	}
+	if (!ok) {
+		msg = filename + " is not a (complete) LINcas output file";
+		std::fclose(f);
+		f = nullptr;
+		return false;
+	}
+	std::sort(index.begin(), index.end(), [](const Block &a, const Block &b) {
+		return (a.job < b.job) || ((a.job == b.job) && (a.column < b.column));
+	});
+	end = pos;
+	return true;
+}
+
+
+std::vector<size_t> LINcasOutputFile::jobs() const {
+	std::vector<size_t> j;
+	for (const Block &b : index) {
+		if (j.empty() || (j.back() != b.job)) j.push_back(b.job);
+	}
+	return j;
+}
+
+
+bool LINcasOutputFile::read(size_t job, const std::string &name, std::vector<double> &x, std::string &msg) {
+	x.clear();
+	size_t k = std::find(names.begin(), names.end(), name) - names.begin();
+	Block key = {uint64_t(job), uint64_t(k), 0, 0, 0};
+	auto it = std::lower_bound(index.begin(), index.end(), key, [](const Block &a, const Block &b) {
+		return (a.job < b.job) || ((a.job == b.job) && (a.column < b.column));
+	});
+	if ((it == index.end()) || (it->job != job) || (it->column != k)) {
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(mtx);
+	if (f == nullptr) {
+		msg = "the output file is not open";
+		return false;
+	}
+	std::vector<unsigned char> z(it->size);
+	if ((seek(f, int64_t(it->offset), SEEK_SET) != 0) || (std::fread(z.data(), 1, z.size(), f) != z.size())) {
+		msg = "cannot read from the output file";
+		return false;
+	}
+	size_t n = it->n;
+	uLongf nb = n * sizeof(double);
+	std::vector<unsigned char> b(nb);
+	if ((uncompress(b.data(), &nb, z.data(), z.size()) != Z_OK) || (nb != n * sizeof(double))) {
+		msg = "the output file is corrupt";
+		return false;
+	}
+	x.resize(n);
+	for (size_t i=0; i<n; i++) {
+		unsigned char v[sizeof(double)];
+		for (size_t j=0; j<sizeof(double); j++) {
+			v[j] = b[j * n + i];
+		}
+		std::memcpy(&x[i], v, sizeof(double));
+	}
+	return true;
+}
@@ -0,0 +1,62 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+
+A file with the output of many model runs (jobs). Each column of the output
+of a job is compressed (zlib) and appended to the file as a block. An index at
+the end of the file has the position of each block, such that the columns of a
+job can be read without reading the rest of the file.
+
+The file has the magic string, the blocks, the index and then the position of
+the index and the magic string again. The index has the column names and, for
+each block, the job, the column (name), the position and size of the block,
+and the number of values. The bytes of the (8 byte) values in a block are
+"shuffled" (the first bytes of all values first, etc.) before compression,
+because that compresses much better. Numbers are stored in native byte order
+*/
+
+#ifndef LINCAS_OUTPUTFILE_H_
+#define LINCAS_OUTPUTFILE_H_
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+
+class LINcasOutput;
+
+class LINcasOutputFile {
+public:
+	~LINcasOutputFile();
+	// for writing. create() and open() fail if a file is open
+	bool create(const std::string &filename, std::string &msg);
+	// write the column of a job; values x[0], x[stride], ..., x[(n-1) * stride]
+	// write() can be called by multiple threads at the same time
+	bool write(size_t job, const std::string &name, const double* x, size_t n, size_t stride, std::string &msg);
+	// write all columns of the output of a job
+	bool write(size_t job, const LINcasOutput &out, std::string &msg);
+	// write the index and close the file
+	bool close(std::string &msg);
+
+	// for reading
+	bool open(const std::string &filename, std::string &msg);
+	std::vector<size_t> jobs() const;
+	std::vector<std::string> columns() const { return names; }
+	// false, with an empty msg, if the job does not have the column
+	bool read(size_t job, const std::string &name, std::vector<double> &x, std::string &msg);
+
+private:
+	struct Block {
+		uint64_t job, column, offset, size, n;
+	};
+	FILE* f=nullptr;
+	bool writing=false;
+	uint64_t end=0;
+	std::vector<std::string> names;
+	std::vector<Block> index;
+	std::mutex mtx;
+};
+
+#endif
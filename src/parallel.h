@@ -0,0 +1,74 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#ifndef LINCAS_PARALLEL_H_
+#define LINCAS_PARALLEL_H_
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <algorithm>
+
+// Run f(job, thread) for jobs 0, ..., n-1 with (up to) nthreads threads.
+// The jobs are taken in order from a shared counter. The thread number can be 
+// used to index per-thread objects, such as a model that is reused for all jobs 
+// of that thread. f must not throw, and must not use the R API
+template <class F>
+void LC_parallel(size_t n, size_t nthreads, F f) {
+	nthreads = std::max(size_t(1), std::min(nthreads, n));
+	if (nthreads == 1) {
+		for (size_t i=0; i<n; i++) f(i, 0);
+		return;
+	}
+	std::atomic<size_t> next(0);
+	std::vector<std::thread> threads;
+	threads.reserve(nthreads);
+	for (size_t t=0; t<nthreads; t++) {
+		threads.emplace_back([&next, &f, n, t]() {
+			for (size_t i = next++; i < n; i = next++) {
+				f(i, t);
+			}
+		});
+	}
+	for (std::thread &t : threads) t.join();
+}
+
+
+// Items 0, ..., n-1 that are made, in order, by a producer thread for the jobs
+// of LC_parallel (that are also taken in order). put() waits while "capacity"
+// items are waiting to be taken, such that the producer does not get too far
+// ahead, and take(i) waits for item i
+template <class T>
+class LC_prefetch {
+public:
+	LC_prefetch(size_t capacity) : capacity(std::max(size_t(1), capacity)) {}
+	void put(size_t i, T x) {
+		std::unique_lock<std::mutex> lock(mtx);
+		notfull.wait(lock, [this]() { return items.size() < capacity; });
+		items.emplace(i, std::move(x));
+		changed.notify_all();
+	}
+	T take(size_t i) {
+		std::unique_lock<std::mutex> lock(mtx);
+		changed.wait(lock, [this, i]() { return items.count(i) > 0; });
+		auto it = items.find(i);
+		T x = std::move(it->second);
+		items.erase(it);
+		notfull.notify_one();
+		return x;
+	}
+private:
+	size_t capacity;
+	std::map<size_t, T> items;
+	std::mutex mtx;
+	std::condition_variable notfull, changed;
+};
+
+
+#endif
@@ -0,0 +1,92 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <algorithm>
+#include "LINTcas.h"
+
+
+// Planting date sweep. Before planting, the model only simulates the soil water 
+// (and nutrient) balance, and that does not depend on the planting date if the 
+// length of the season (HVDATE - PLDATE) is the same. This part is therefore 
+// simulated only once, until the last planting date. A crop simulation is started 
+// from that trajectory at each planting date (or earlier if there is fertilizer 
+// applied before planting).
+// The output has the states at harvest for each planting date 
+bool LC_planting_sweep(const LINcasModel &base, std::vector<long> dates, size_t nthreads, LINcasOutput &out, std::vector<std::string> &messages) {
+
+	std::sort(dates.begin(), dates.end());
+	dates.erase(std::unique(dates.begin(), dates.end()), dates.end());
+	if (dates.empty()) {
+		messages.push_back("no planting dates");
+		return false;
+	}
+	if (dates[0] < base.control.modelstart) {
+		messages.push_back("model cannot start after the planting date");
+		return false;
+	}
+	long season = base.management.HVDATE - base.management.PLDATE;
+	if (base.weather.date.size() == 0) {
+		messages.push_back("no weather data");
+		return false;
+	}
+	long wfirst = base.weather.date[0];
+	long wlast = base.weather.date[base.weather.date.size() - 1];
+	for (long d : dates) {
+		if ((d < wfirst) || ((d + season) > wlast)) {
+			messages.push_back("there is no weather for the season with planting date " + LC_date_string(d));
+			return false;
+		}
+	}
+
+	// days before planting of the first fertilizer application
+	long first = 0;
+	if (base.control.NPKmodel && (base.management.FERTAB.size() > 0)) {
+		for (double d : base.management.FERTAB[0]) {
+			first = std::min(first, long(d));
+		}
+	}
+
+	LINcasOverlay ov;
+	LINcasModel pre;
+	ov.apply(base, pre);
+	pre.control.outvars = "batch";
+	pre.management.PLDATE = dates.back();
+	pre.management.HVDATE = dates.back() + season;
+	pre.management.harvests.clear();
+	pre.reset();
+	if ((!pre.start()) || ((dates[0] + first) < base.control.modelstart)) {
+		messages = pre.messages;
+		if (!pre.fatalError) {
+			messages.push_back("model cannot start after the first fertilizer application");
+		}
+		return false;
+	}
+
+	// the shared trajectory before planting
+	std::vector<LINcasSnapshot> start(dates.size());
+	for (size_t i=0; i<dates.size(); ) {
+		if (pre.weather.date[pre.time] == (dates[i] + first)) {
+			start[i] = pre.snapshot();
+			i++;
+		} else if (!pre.step_day()) {
+			messages = pre.messages;
+			messages.push_back("the crop emerged before the last planting date");
+			return false;
+		}
+	}
+
+	// a crop simulation for each planting date, that continues from the shared trajectory
+	std::vector<double> keys(dates.begin(), dates.end());
+	return LC_runs(base, "PLDATE", keys, nthreads, [&](size_t i, LINcasModel &m) {
+		m.management.PLDATE = dates[i];
+		m.management.HVDATE = dates[i] + season;
+		if (!m.start()) return false;
+		LINcasSnapshot x = start[i];
+		x.maxdur = m.maxdur;
+		m.restore(x);
+		return true;
+	}, out, messages);
+}
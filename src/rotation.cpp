@@ -0,0 +1,146 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <algorithm>
+#include "LINTcas.h"
+
+
+// the soil states that are passed on to the next season
+static const std::vector<double LINcasVariables::*> soilPools = {
+	&LINcasVariables::NMINT, &LINcasVariables::PMINT, &LINcasVariables::KMINT,
+	&LINcasVariables::NMINS, &LINcasVariables::PMINS, &LINcasVariables::KMINS,
+	&LINcasVariables::NMINF, &LINcasVariables::PMINF, &LINcasVariables::KMINF
+};
+
+
+// A reducer computes a value for a season from the daily values of an output
+// variable (see "custom" output variables) in column k of v
+static const std::vector<std::string> reducers = {"last", "sum", "mean", "min", "max"};
+
+static double reduce(const std::string &fun, const std::vector<double> &v, size_t k, size_t nc) {
+	size_t nr = v.size() / nc;
+	if (nr == 0) return NAN;
+	double x;
+	if (fun == "last") {
+		x = v[(nr-1) * nc + k];
+	} else if ((fun == "sum") || (fun == "mean")) {
+		x = 0;
+		for (size_t i=0; i<nr; i++) x += v[i * nc + k];
+		if (fun == "mean") x /= nr;
+	} else if (fun == "min") {
+		x = INFINITY;
+		for (size_t i=0; i<nr; i++) x = std::min(x, v[i * nc + k]);
+	} else {
+		x = -INFINITY;
+		for (size_t i=0; i<nr; i++) x = std::max(x, v[i * nc + k]);
+	}
+	return x;
+}
+
+
+// A sequence of seasons (plantings and harvests) over one weather series. Each
+// season starts the day after the last simulated day of the previous season.
+// The soil water content and the soil nutrient pools at the end of a season
+// are the initial values for the next season. The output has the states at
+// harvest for each season, and the reduced daily values of "vars"
+bool LC_rotation(const LINcasModel &base, const std::vector<long> &plant, const std::vector<long> &harvest, const std::vector<std::string> &vars, const std::vector<std::string> &funs, LINcasOutput &out, std::vector<std::string> &messages) {
+
+	size_t n = plant.size();
+	if ((n == 0) || (harvest.size() != n)) {
+		messages.push_back("the number of planting and harvest dates must be the same");
+		return false;
+	}
+	for (size_t i=0; i<n; i++) {
+		if ((plant[i] >= harvest[i]) || ((i > 0) && (plant[i] <= harvest[i-1]))) {
+			messages.push_back("each planting date must be after the previous harvest date");
+			return false;
+		}
+	}
+	if (vars.size() != funs.size()) {
+		messages.push_back("each output variable needs a reducer");
+		return false;
+	}
+	for (const std::string &f : funs) {
+		if (std::find(reducers.begin(), reducers.end(), f) == reducers.end()) {
+			messages.push_back("unknown reducer: " + f);
+			return false;
+		}
+	}
+
+	out.names = {"season", "PLDATE", "HVDATE", "step"};
+	for (const LINcasVariable &v : LC_variables()) {
+		if (v.npk && !base.control.NPKmodel) continue;
+		out.names.push_back(v.name);
+	}
+	for (size_t j=0; j<vars.size(); j++) {
+		out.names.push_back(vars[j] + "_" + funs[j]);
+	}
+	size_t nc = out.names.size();
+	out.values.clear();
+	out.values.reserve(n * nc);
+
+	LINcasOverlay ov;
+	LINcasModel m;
+	double WC = 0;
+	std::vector<double> pools(soilPools.size());
+	LINcasGeneratorState wstate;
+	long next = base.control.modelstart;
+	for (size_t i=0; i<n; i++) {
+		ov.apply(base, m);
+		m.control.modelstart = next;
+		m.management.PLDATE = plant[i];
+		m.management.HVDATE = harvest[i];
+		m.management.harvests.clear();
+		m.control.outvars = "custom";
+		m.control.outnames = vars;
+		m.reset();
+		if (!m.start()) {
+			messages.insert(messages.end(), m.messages.begin(), m.messages.end());
+			return false;
+		}
+		if (i > 0) {
+			// continue with the soil of the previous season
+			m.S.WA = 1000 * m.S.ROOTD * WC;
+			if (m.control.NPKmodel) {
+				for (size_t j=0; j<soilPools.size(); j++) {
+					m.S.*soilPools[j] = pools[j];
+				}
+				// the mineralization rate as in initialize(), with NMINS = 0.75 * NMINI
+				m.soil.RTNMINS = (1/0.9) * (m.S.NMINS / 0.75) / m.season_length;
+				m.soil.RTPMINS = (1/0.9) * (m.S.PMINS / 0.75) / m.season_length;
+				m.soil.RTKMINS = (1/0.9) * (m.S.KMINS / 0.75) / m.season_length;
+			}
+			// and the same stream of generated weather
+			m.wstate = wstate;
+		}
+		while (m.step_day()) {}
+		messages.insert(messages.end(), m.messages.begin(), m.messages.end());
+		if (m.fatalError) {
+			return false;
+		}
+
+		std::vector<double> daily = std::move(m.out.values);
+		m.out.values.clear();
+		m.harvest(plant[i]);
+		out.values.push_back(double(i + 1));
+		out.values.push_back(double(plant[i]));
+		out.values.push_back(double(harvest[i]));
+		// skip the date added by harvest()
+		out.values.insert(out.values.end(), m.out.values.begin() + 1, m.out.values.end());
+		for (size_t j=0; j<vars.size(); j++) {
+			// the first column of the daily output is "step"
+			out.values.push_back(reduce(funs[j], daily, j + 1, vars.size() + 1));
+		}
+
+		WC = 0.001 * m.S.WA / m.S.ROOTD;
+		for (size_t j=0; j<soilPools.size(); j++) {
+			pools[j] = m.S.*soilPools[j];
+		}
+		wstate = m.wstate;
+		next = m.A.date + long(m.DELT);
+	}
+	return true;
+}
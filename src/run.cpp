@@ -2,6 +2,87 @@
 #include "LINTcas.h"
 
 
+// select the output variables. That is only done again if the control settings
+// have changed, so that a model that is run again does not allocate memory 
+void LINcasModel::setOutput() {
+	bool harvests = multipleHarvests();
+	if ((!out.names.empty()) && (out.outvars == control.outvars) && (out.NPKmodel == control.NPKmodel) && (out.outnames == control.outnames) && (out.harvests == harvests)) {
+		return;
+	}
+	out.outvars = control.outvars;
+	out.NPKmodel = control.NPKmodel;
+	out.outnames = control.outnames;
+	out.harvests = harvests;
+	out.events = false;
+	out.variables.clear();
+	const std::vector<LINcasVariable> &vars = LC_variables();
+	if (harvests) {
+		// the states at each harvest date; see harvest()
+		out.names = {"harvest", "step"};
+		for (const LINcasVariable &v : vars) {
+			if (v.npk && !control.NPKmodel) continue;
+			out.names.push_back(v.name);
+		}
+		return;
+	}
+	if (control.outvars == "events") {
+		out.names = {"step", "event", "value"};
+		out.events = true;
+		return;
+	}
+	out.names = {"step"};
+	if (control.outvars == "batch") {
+		out.names.push_back("WSO");
+		return;
+	}
+	if (control.outvars == "custom") {
+		for (const std::string &s : control.outnames) {
+			int i = LC_variable_index(s.c_str());
+			bool rate = false;
+			if ((i < 0) && (s.size() > 1) && (s[0] == 'R')) {
+				i = LC_variable_index(s.c_str() + 1);
+				rate = true;
+			}
+			if ((i < 0) || (vars[i].npk && !control.NPKmodel)) {
+				messages.push_back("unknown output variable: " + s);
+				fatalError = true;
+				out.names.clear();
+				return;
+			}
+			out.variables.push_back({vars[i].value, rate});
+			out.names.push_back(s);
+		}
+		return;
+	}
+	for (const LINcasVariable &v : vars) {
+		if (v.npk && !control.NPKmodel) continue;
+		out.variables.push_back({v.value, false});
+		out.names.push_back(v.name);
+	}
+	if (control.outvars == "full") {
+		for (const LINcasVariable &v : vars) {
+			if (v.npk && !control.NPKmodel) continue;
+			out.variables.push_back({v.value, true});
+			out.names.push_back("R" + v.name);
+		}
+	}
+}
+
+
+// prepare for a new run. The memory that was allocated in a previous run is kept
+void LINcasModel::reset() {
+	messages.clear();
+	fatalError = false;
+	S = LINcasStates();
+	R = LINcasRates();
+	emerged = false;
+	eventlog = LINcasEventLog();
+	unreliable = 0;
+	out.values.clear();
+	ended = true; // until start()
+}
+
+
 void LINcasModel::initialize(long maxdur) {
 
 	S.ROOTD = crop.ROOTDI; 
@@ -25,59 +106,111 @@ void LINcasModel::initialize(long maxdur) {
 		S.PMINS = 0.75 * soil.PMINI;  // g P m-2: Available organic phosphorus in the soil
 		S.KMINS = 0.75 * soil.KMINI;  // g K m-2: Available organic potassium in the soil
 		
-		if (control.outvars == "batch") {
-			out.names = {"step", "WSO"};
-		} else {
-			out.names = {"step", "ROOTD", "WA", "TSUM", "TSUMCROP", "TSUMCROPLEAFAGE", "DORMTSUM", "PUSHDORMRECTSUM", "PUSHREDISTENDTSUM", "DORMTIME", "WCUTTING", "TRAIN", "PAR", "LAI", "WLVD", "WLV", "WST", "WSO", "WRT", "WLVG", "TRAN", "EVAP", "PTRAN", "PEVAP", "RUNOFF", "NINTC", "DRAIN", "REDISTLVG", "REDISTSO", "PUSHREDISTSUM", "WSOFASTRANSLSO", "IRRIG", "NCUTTING", "PCUTTING", "KCUTTING", "ANLVG", "ANLVD", "ANST", "ANRT", "ANSO", "APLVG", "APLVD", "APST", "APRT", "APSO", "AKLVG", "AKLVD", "AKST", "AKRT", "AKSO", "NMINT", "PMINT", "KMINT", "NMINS", "PMINS", "KMINS", "NMINF", "PMINF", "KMINF"};
-			if (control.outvars == "full") {
-				out.names.insert(out.names.end(), {"RROOTD", "RWA", "RTSUM", "RTSUMCROP", "RTSUMCROPLEAFAGE", "RDORMTSUM", "RPUSHDORMRECTSUM", "RPUSHREDISTENDTSUM", "RDORMTIME", "RWCUTTING", "RTRAIN", "RPAR", "RLAI", "RWLVD", "RWLV", "RWST", "RWSO", "RWRT", "RWLVG", "RTRAN", "REVAP", "RPTRAN", "RPEVAP", "RRUNOFF", "RNINTC", "RDRAIN", "RREDISTLVG", "RREDISTSO", "RPUSHREDISTSUM", "RWSOFASTRANSLSO", "RIRRIG", "RNCUTTING", "RPCUTTING", "RKCUTTING", "RANLVG", "RANLVD", "RANST", "RANRT", "RANSO", "RAPLVG", "RAPLVD", "RAPST", "RAPRT", "RAPSO", "RAKLVG", "RAKLVD", "RAKST", "RAKRT", "RAKSO", 
-				"RNMINT", "RPMINT", "RKMINT", "RNMINS", "RPMINS", "RKMINS", "RNMINF", "RPMINF", "RKMINF"});
-			}
-		}
+	}
+	setOutput();
+	if (out.harvests) {
+		out.values.reserve(management.harvests.size() * out.names.size());
 	} else {
-		if (control.outvars == "batch") {
-			out.names = {"step", "WSO"};
-		} else {
-			out.names = {"step", "ROOTD", "WA", "TSUM", "TSUMCROP", "TSUMCROPLEAFAGE", "DORMTSUM", "PUSHDORMRECTSUM", "PUSHREDISTENDTSUM", "DORMTIME", "WCUTTING", "TRAIN", "PAR", "LAI", "WLVD", "WLV", "WST", "WSO", "WRT", "WLVG", "TRAN", "EVAP", "PTRAN", "PEVAP", "RUNOFF", "NINTC", "DRAIN", "REDISTLVG", "REDISTSO", "PUSHREDISTSUM", "WSOFASTRANSLSO", "IRRIG"};
-			if (control.outvars == "full") {
-				out.names.insert(out.names.end(), {"RROOTD", "RWA", "RTSUM", "RTSUMCROP", "RTSUMCROPLEAFAGE", "RDORMTSUM", "RPUSHDORMRECTSUM", "RPUSHREDISTENDTSUM", "RDORMTIME", "RWCUTTING", "RTRAIN", "RPAR", "RLAI", "RWLVD", "RWLV", "RWST", "RWSO", "RWRT", "RWLVG", "RTRAN", "REVAP", "RPTRAN", "RPEVAP", "RRUNOFF", "RNINTC", "RDRAIN", "RREDISTLVG", "RREDISTSO", "RPUSHREDISTSUM", "RWSOFASTRANSLSO", "RIRRIG"} );
-			}
-		}
+		out.values.reserve(maxdur * out.names.size());
+	}
+}
+
+
+void LINcasModel::weather_day(size_t i, LINcasDay &d) {
+	if (weather.generator) {
+		wstate.next(*weather.generator, weather.date[i], d);
+	} else {
+		weather.get(i, d);
+	}
+	if (weather.transform) {
+		weather.transform->apply(weather.date[i], d);
 	}
-	out.values.reserve(maxdur * out.names.size());
 }
 
+// the days in the next time step: control.DELT, but one day for a young crop, 
+// and the last step can be shorter
+unsigned LINcasModel::step_length() const {
+	if ((S.TSUMCROP < crop.TSUMLA_MIN) && (S.LAI < crop.LAIEXPOEND)) return 1;
+	return std::min({unsigned(control.DELT), unsigned(weather.date.size() - time), maxdur - step + 1});
+}
+
+// the days in the next time step, but not beyond date "until"
+unsigned LINcasModel::step_length(long until) const {
+	unsigned n = step_length();
+	long left = until - weather.date[time] + 1;
+	return (left < long(n)) ? unsigned(std::max(1L, left)) : n;
+}
 
 bool LINcasModel::weather_step() {
+	return weather_step(step_length());
+}
+
+// the weather of the next time step of "days" days. With more than one day, 
+// this is the mean weather of the days in the step
+bool LINcasModel::weather_step(unsigned days) {
 	A.date = weather.date[time];
+	DELT = days;
+	LINcasDay d;
+	weather_day(time, d);
+	if (DELT > 1) {
+		LINcasDay x;
+		for (size_t i=1; i<DELT; i++) {
+			weather_day(time + i, x);
+			d.srad += x.srad; d.tmin += x.tmin; d.tmax += x.tmax;
+			d.prec += x.prec; d.wind += x.wind; d.vapr += x.vapr;
+		}
+		d.srad /= DELT; d.tmin /= DELT; d.tmax /= DELT;
+		d.prec /= DELT; d.wind /= DELT; d.vapr /= DELT;
+	}
 
-	A.SRAD = weather.srad[time] / 1000.;
-	A.WIND = weather.wind[time];
-	A.VAPR = weather.vapr[time];
-	A.PREC = weather.prec[time];
+	A.SRAD = d.srad / 1000.;
+	A.WIND = d.wind;
+	A.VAPR = d.vapr;
+	A.PREC = d.prec;
 
-	double SatVP_TMMN = SatVP(weather.tmin[time]);
-	double SatVP_TMMX = SatVP(weather.tmax[time]);
+	double SatVP_TMMN = SatVP(d.tmin);
+	double SatVP_TMMX = SatVP(d.tmax);
   // vapour pressure deficits;
 	A.VPD_MN = std::max(0., SatVP_TMMN - A.VAPR);
 	A.VPD_MX = std::max(0., SatVP_TMMX - A.VAPR);
-	A.TAVG = 0.5 * (weather.tmin[time] + weather.tmax[time]);   // Deg. C     :     daily average temperature
+	A.TAVG = 0.5 * (d.tmin + d.tmax);   // Deg. C     :     daily average temperature
+	A.penmanTerms();
 
 	return true;
 }
 
-void LINcasModel::run() {
+// check the dates and initialize the model. Returns false if the model cannot be run.
+// If "partial" is true, the weather data do not need to go up to the harvest date
+// (the simulation ends at the end of the weather data)
+bool LINcasModel::start(bool partial) {
 
-	if (control.modelstart < weather.date[0]) {
+	if ((control.DELT < 1) || (control.DELT != std::floor(control.DELT))) {
+		messages.push_back("the time step (DELT) must be a whole number of days");
+	    fatalError = true;
+		return false;
+	}
+	// the nutrient uptake, translocation and mineralization of the NPK model 
+	// are not stable with coarse time steps (uptake is capped at the demand at 
+	// the start of the step, and nutrients are translocated in TCNPKT days)
+	if (control.NPKmodel && (control.DELT > 1)) {
+		messages.push_back("the NPK model requires a time step (DELT) of one day");
+	    fatalError = true;
+		return false;
+	}
+	if (weather.date.size() == 0) {
+		messages.push_back("no weather data");
+	    fatalError = true;
+		return false;
+	} else if (control.modelstart < weather.date[0]) {
 		std::string m = "model cannot start before beginning of the weather data";
 	    messages.push_back(m);
 	    fatalError = true;
-		return;
+		return false;
 	} else if (control.modelstart > weather.date[weather.date.size()-1]) {
 		std::string m = "model cannot start after the end of the weather data";
 	    messages.push_back(m);
 	    fatalError = true;
-		return;
+		return false;
 	} else {
 // get start time relative to weather data
 		auto it = std::find(weather.date.begin(), weather.date.end(), control.modelstart);
@@ -91,51 +224,208 @@ void LINcasModel::run() {
 	if (control.modelstart > management.PLDATE) {
 		messages.push_back("model cannot start after the planting date");
 	    fatalError = true;
-		return;		
+		return false;		
 	}		
-	if (management.PLDATE >= management.HVDATE) {
+	if ((management.PLDATE >= management.HVDATE) || (multipleHarvests() && (management.PLDATE >= management.harvests[0]))) {
 		messages.push_back("harvest date must be after the planting date");
 	    fatalError = true;
-		return;
+		return false;
 	}
 
-	unsigned maxdur = management.HVDATE - control.modelstart + 1;
-	if (weather.date.size() < (time + maxdur)) {
+	maxdur = management.HVDATE - control.modelstart + 1;
+	if ((!partial) && (weather.date.size() < (time + maxdur))) {
 		messages.push_back("harvest date beyond the end of weather data");
 	    fatalError = true;
-		return;		
+		return false;		
 	}
 	
 	season_length = management.HVDATE - management.PLDATE;	
+	if (!calendar.compile(management, control.NPKmodel, control.modelstart, maxdur, messages)) {
+	    fatalError = true;
+		return false;
+	}
 	initialize(maxdur);
-	
-	step = 1;	
+	if (weather.generator) {
+		wstate.seed(weather.seed);
+	}
+	step = 1;
+	nextharvest = 0;
+	ended = fatalError;
+	return !fatalError;
+}
+
+
+// the events on each day from start to start+ndays-1. Fertilizer applications 
+// before the start or after the (last) harvest date are ignored with a warning
+bool LINcasCalendar::compile(const LINcasManagement &m, bool NPKmodel, long start, size_t ndays, std::vector<std::string> &messages) {
+	first = start;
+	events.assign(ndays, 0);
+	fertilizer.assign(ndays, -1);
+	for (size_t i = std::max(0L, m.PLDATE - start); i < ndays; i++) {
+		events[i] |= LC_PLANTED;
+	}
+	for (long d : m.harvests) {
+		size_t i = d - start;
+		if (i < ndays) events[i] |= LC_HARVEST;
+	}
+	if ((!NPKmodel) || (m.FERTAB.size() == 0)) return true;
+
+	long last = m.harvests.empty() ? m.HVDATE : m.harvests.back();
+	size_t outside = 0;
+	const std::vector<double> &days = m.FERTAB[0];
+	for (size_t j=0; j<days.size(); j++) {
+		// FERTAB has days after planting
+		double d = days[j];
+		if (std::isnan(d)) continue;
+		if ((d != std::floor(d)) || (d < (start - m.PLDATE)) || (d > (last - m.PLDATE))) {
+			outside++;
+			continue;
+		}
+		size_t i = m.PLDATE + long(d) - start;
+		if (i >= ndays) continue; // after HVDATE in a run for an earlier harvest
+		if (fertilizer[i] >= 0) {
+			messages.push_back("more than one fertilizer application on day " + std::to_string(long(d)) + " after planting");
+			return false;
+		}
+		fertilizer[i] = j;
+		events[i] |= LC_FERTILIZE;
+	}
+	if (outside > 0) {
+		messages.push_back(std::to_string(outside) + " fertilizer application(s) outside of the simulation period ignored");
+	}
+	return true;
+}
+
+
+// simulate one day. Returns false when the simulation has ended
+bool LINcasModel::step_day() {
+	if (ended) return false;
+	if ((step > maxdur) || (time >= weather.date.size()) || (!weather_step())) {
+		ended = true;
+		return false;
+	}
+	return crop_step();
+}
+
+// simulate one time step that does not go beyond date "until" (for runs up 
+// to a date). Returns false when the simulation has ended
+bool LINcasModel::step_day(long until) {
+	if (ended) return false;
+	if ((step > maxdur) || (time >= weather.date.size()) || (!weather_step(step_length(until)))) {
+		ended = true;
+		return false;
+	}
+	return crop_step();
+}
+
+// simulate one day with the weather in A (see step_day)
+bool LINcasModel::crop_step() {
 	if (control.NPKmodel) {
-		while (step <= maxdur) {
-			if (!weather_step()) break;
-			ratesNPK();
-			outputNPK();
-			statesNPK();
-			if (S.TSUM >= crop.FINTSUM) break;
-			time++;
-			step++;
-			if (fatalError) return;
-		}		
-	} else {
-		while (step <= maxdur) {
-			if (!weather_step()) break;
-			rates();
-			output();
-			states();
-			if (S.TSUM >= crop.FINTSUM) break;
-			time++;
-			step++;
-			if (fatalError) return;
+		ratesNPK();
+		output();
+		statesNPK();
+	} else if (emerged || !preemergence_step()) {
+		rates();
+		output();
+		states();
+	}
+	bool done = S.TSUM >= crop.FINTSUM;
+	if (!done) {
+		time += DELT;
+		step += DELT;
+	}
+	for (unsigned i=0; i<DELT; i++) {
+		if ((calendar.get(A.date + i) & LC_HARVEST) && (!control.NPKmodel)) {
+			harvest(A.date + i);
+			nextharvest++;
 		}
 	}
-	
-	if (control.outvars == "batch") {
+	ended = done || fatalError || (step > maxdur);
+	return !ended;
+}
+
+
+void LINcasModel::finish() {
+	if (out.harvests) {
+		// the crop matured before the last harvest date(s)
+		if (!control.NPKmodel) {
+			for (; nextharvest < management.harvests.size(); nextharvest++) {
+				harvest(management.harvests[nextharvest]);
+			}
+		}
+	} else if (control.outvars == "batch") {
 		out.values = {double(step), S.WSO};		
+	} else if (out.events) {
+		out.values.insert(out.values.end(), {double(step), double(LC_END), S.WSO});
+	}
+}
+
+
+// store the states at a harvest date. These are the same as for a model 
+// run with that harvest date (with "batch" output for WSO) 
+void LINcasModel::harvest(long date) {
+	out.values.push_back(double(date));
+	out.values.push_back(double(step));
+	for (const LINcasVariable &v : LC_variables()) {
+		if (v.npk && !control.NPKmodel) continue;
+		out.values.push_back(S.*v.value);
 	}
 }
 
+
+void LINcasModel::run() {
+	if (multipleHarvests() && control.NPKmodel) {
+		runHarvests();
+		return;
+	}
+	reset();
+	if (!start()) return;
+	while (step_day()) {}
+	if (fatalError) return;
+	finish();
+}
+
+
+// With the NPK model, the soil mineralization rates depend on the length of the 
+// season. The trajectories for different harvest dates are therefore not the 
+// same, and the model is run for each harvest date
+void LINcasModel::runHarvests() {
+	long last = management.HVDATE;
+	// buffers that are kept, so that a model that is run again does not allocate memory
+	harvestvalues.clear();
+	harvestmessages.clear();
+	for (size_t i=0; i<management.harvests.size(); i++) {
+		management.HVDATE = management.harvests[i];
+		reset();
+		if (start()) {
+			while (step_day()) {}
+			if (!fatalError) {
+				harvest(management.HVDATE);
+				harvestvalues.insert(harvestvalues.end(), out.values.begin(), out.values.end());
+			}
+		}
+		harvestmessages.insert(harvestmessages.end(), messages.begin(), messages.end());
+		if (fatalError) break;
+	}
+	management.HVDATE = last;
+	out.values.assign(harvestvalues.begin(), harvestvalues.end());
+	messages.assign(harvestmessages.begin(), harvestmessages.end());
+}
+
+
+bool LINcasModel::multipleHarvests() const {
+	return management.harvests.size() > 1;
+}
+
+
+// one or more harvest dates. The model runs until the last one
+void LINcasManagement::setHarvest(std::vector<double> dates) {
+	harvests.clear();
+	if (dates.empty()) return;
+	std::sort(dates.begin(), dates.end());
+	dates.erase(std::unique(dates.begin(), dates.end()), dates.end());
+	HVDATE = dates.back();
+	if (dates.size() > 1) {
+		harvests.insert(harvests.end(), dates.begin(), dates.end());
+	}
+}
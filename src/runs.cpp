@@ -0,0 +1,66 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <algorithm>
+#include "LINTcas.h"
+#include "parallel.h"
+
+
+// A set of runs of the base model that only differ in their setup. For run i,
+// a model gets the parameters and weather of the base model, with "batch"
+// output and no harvest dates, and is reset. setup(i, m) then makes the
+// changes for that run, and starts the model (and may restore a snapshot).
+// It returns false if the model could not be started.
+// The output has a row for each run, with keys[i], the step and the states at
+// harvest. These are NAN for runs that failed, and false is returned if there
+// are any
+bool LC_runs(const LINcasModel &base, const std::string &key, const std::vector<double> &keys, size_t nthreads, const LINcasRunSetup &setup, LINcasOutput &out, std::vector<std::string> &messages) {
+
+	size_t n = keys.size();
+	out.names = {key, "step"};
+	std::vector<double LINcasVariables::*> states;
+	for (const LINcasVariable &v : LC_variables()) {
+		if (v.npk && !base.control.NPKmodel) continue;
+		out.names.push_back(v.name);
+		states.push_back(v.value);
+	}
+	size_t nc = out.names.size();
+	out.values.assign(n * nc, NAN);
+	for (size_t i=0; i<n; i++) {
+		out.values[i * nc] = keys[i];
+	}
+	std::vector<std::vector<std::string>> msgs(n);
+	std::vector<char> failed(n, 0);
+
+	LINcasOverlay ov;
+	std::vector<LINcasModel> pool(std::max(size_t(1), nthreads));
+	LC_parallel(n, nthreads, [&](size_t i, size_t t) {
+		LINcasModel &m = pool[t];
+		ov.apply(base, m);
+		m.control.outvars = "batch";
+		m.management.harvests.clear();
+		m.reset();
+		bool ok = setup(i, m);
+		if (ok) {
+			while (m.step_day()) {}
+		}
+		if (ok && !m.fatalError) {
+			double* row = &out.values[i * nc];
+			row[1] = m.step;
+			for (size_t j=0; j<states.size(); j++) {
+				row[j+2] = m.S.*states[j];
+			}
+		} else {
+			failed[i] = 1;
+		}
+		msgs[i] = m.messages;
+	});
+
+	for (size_t i=0; i<n; i++) {
+		messages.insert(messages.end(), msgs[i].begin(), msgs[i].end());
+	}
+	return std::find(failed.begin(), failed.end(), 1) == failed.end();
+}
@@ -0,0 +1,175 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include "LINTcas.h"
+
+
+static uint32_t fnv1a(const char* s, uint32_t seed) {
+	uint32_t h = 2166136261u ^ seed;
+	for (; *s; s++) {
+		h ^= (unsigned char) *s;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+// The table size is a power of 2 of at least n*n/2 and the seed is increased
+// until all names hash to a different slot. That takes a few tries at most
+LINcasNameIndex::LINcasNameIndex(const std::vector<std::string> &names) : keys(names) {
+	size_t n = 1;
+	while (n < (names.size() * names.size() / 2 + 1)) n *= 2;
+	mask = n - 1;
+	for (seed = 0; ; seed++) {
+		slots.assign(n, -1);
+		bool ok = true;
+		for (size_t i=0; i<keys.size(); i++) {
+			int &k = slots[fnv1a(keys[i].c_str(), seed) & mask];
+			if (k >= 0) {
+				ok = false;
+				break;
+			}
+			k = i;
+		}
+		if (ok) break;
+	}
+}
+
+int LINcasNameIndex::find(const char* name) const {
+	int k = slots[fnv1a(name, seed) & mask];
+	if ((k < 0) || (keys[k] != name)) return -1;
+	return k;
+}
+
+
+static std::vector<LINcasParameter> make_parameters() {
+	std::vector<LINcasParameter> p;
+	LINcasParameter x;
+#define LC_CROP(n, isnpk) x = LINcasParameter(); x.name = #n; x.group = 'c'; x.npk = isnpk; x.ncol = 0; x.crop = &LINcasCropParameters::n; p.push_back(x);
+#define LC_CROPTB(n, nc, isnpk) x = LINcasParameter(); x.name = #n; x.group = 'c'; x.npk = isnpk; x.ncol = nc; x.croptable = &LINcasCropParameters::n; p.push_back(x);
+#define LC_SOIL(n, isnpk) x = LINcasParameter(); x.name = #n; x.group = 's'; x.npk = isnpk; x.ncol = 0; x.soil = &LINcasSoilParameters::n; p.push_back(x);
+#define LC_DATE(n) x = LINcasParameter(); x.name = #n; x.group = 'm'; x.npk = false; x.ncol = 0; x.date = &LINcasManagement::n; p.push_back(x);
+#define LC_MGMT(n, v) x = LINcasParameter(); x.name = #n; x.group = 'm'; x.npk = false; x.ncol = 0; x.mgmt = &LINcasManagement::n; x.optional = true; p.push_back(x);
+#define LC_MGMTTB(n, nc) x = LINcasParameter(); x.name = #n; x.group = 'm'; x.npk = true; x.ncol = nc; x.mgmttable = &LINcasManagement::n; p.push_back(x);
+
+#define X(n) LC_CROP(n, false)
+	LC_CROP_PARAMETERS(X)
+#undef X
+#define X(n, nc) LC_CROPTB(n, nc, false)
+	LC_CROP_TABLES(X)
+#undef X
+#define X(n) LC_CROP(n, true)
+	LC_CROP_NPK_PARAMETERS(X)
+#undef X
+#define X(n, nc) LC_CROPTB(n, nc, true)
+	LC_CROP_NPK_TABLES(X)
+#undef X
+#define X(n) LC_SOIL(n, false)
+	LC_SOIL_PARAMETERS(X)
+#undef X
+#define X(n) LC_SOIL(n, true)
+	LC_SOIL_NPK_PARAMETERS(X)
+#undef X
+	LC_MANAGEMENT_PARAMETERS(LC_DATE)
+	LC_MANAGEMENT_NPK_TABLES(LC_MGMTTB)
+	LC_MANAGEMENT_OPTIONAL(LC_MGMT)
+
+#undef LC_CROP
+#undef LC_CROPTB
+#undef LC_SOIL
+#undef LC_DATE
+#undef LC_MGMT
+#undef LC_MGMTTB
+	return p;
+}
+
+
+static std::vector<LINcasVariable> make_variables() {
+	std::vector<LINcasVariable> v;
+#define X(n, isnpk) v.push_back({#n, isnpk, &LINcasVariables::n});
+	LC_VARIABLES(X)
+#undef X
+	return v;
+}
+
+template <class T>
+static std::vector<std::string> get_names(const std::vector<T> &x) {
+	std::vector<std::string> nms;
+	nms.reserve(x.size());
+	for (const T &d : x) nms.push_back(d.name);
+	return nms;
+}
+
+
+const std::vector<LINcasParameter>& LC_parameters() {
+	static const std::vector<LINcasParameter> p = make_parameters();
+	return p;
+}
+
+int LC_parameter_index(const char* name) {
+	static const LINcasNameIndex idx(get_names(LC_parameters()));
+	return idx.find(name);
+}
+
+const std::vector<LINcasVariable>& LC_variables() {
+	static const std::vector<LINcasVariable> v = make_variables();
+	return v;
+}
+
+int LC_variable_index(const char* name) {
+	static const LINcasNameIndex idx(get_names(LC_variables()));
+	return idx.find(name);
+}
+
+
+void LINcasParameter::set(LINcasModel &m, double v) const {
+	if (crop) {
+		m.crop.*crop = v;
+	} else if (soil) {
+		m.soil.*soil = v;
+	} else if (date) {
+		m.management.*date = long(v);
+		if (date == &LINcasManagement::HVDATE) {
+			m.management.harvests.clear();
+		}
+	} else if (mgmt) {
+		m.management.*mgmt = v;
+	}
+}
+
+double LINcasParameter::get(const LINcasModel &m) const {
+	if (crop) return m.crop.*crop;
+	if (soil) return m.soil.*soil;
+	if (date) return m.management.*date;
+	if (mgmt) return m.management.*mgmt;
+	return NAN;
+}
+
+LINcasTable& LINcasParameter::table(LINcasModel &m) const {
+	if (croptable) return m.crop.*croptable;
+	return m.management.*mgmttable;
+}
+
+const LINcasTable& LINcasParameter::table(const LINcasModel &m) const {
+	if (croptable) return m.crop.*croptable;
+	return m.management.*mgmttable;
+}
+
+
+// set the parameters (and weather) of m to those of base, with the changes in the overlay
+void LINcasOverlay::apply(const LINcasModel &base, LINcasModel &m) const {
+	m.crop = base.crop;
+	m.soil = base.soil;
+	m.management = base.management;
+	m.control = base.control;
+	m.weather = base.weather;
+	const std::vector<LINcasParameter> &pars = LC_parameters();
+	for (const auto &v : values) {
+		pars[v.first].set(m, v.second);
+	}
+	for (const auto &v : tables) {
+		pars[v.first].table(m) = v.second;
+	}
+}
@@ -0,0 +1,120 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+
+The parameters and the state variables of the model are listed here, once.
+These lists (X-macros) are used to define the class members, to read 
+the parameters from R, for the Rcpp module, and for the model output.
+*/
+
+#ifndef LINCAS_SCHEMA_H_
+#define LINCAS_SCHEMA_H_
+
+// crop parameters: X(name)
+#define LC_CROP_PARAMETERS(X) \
+	X(TWCSD) X(FRACRNINTC) X(RECOV) X(TRANCO) X(WCUTTINGUNIT) X(NCUTTINGS) X(WCUTTINGIP) \
+	X(ROOTDI) X(SLAI) X(WLVI) X(LAII) X(WCUTTINGMINPRO) X(FST_CUTT) X(FRT_CUTT) X(FLV_CUTT) \
+	X(FSO_CUTT) X(RDRWCUTTING) X(FPAR) X(K_EXT) X(LUE_OPT) X(RRDMAX) X(RDRB) X(LAICR) \
+	X(RDRSHM) X(FRACTLLFENHSH) X(FASTRANSLSO) X(SLA_MAX) X(RGRL) X(LAIEXPOEND) X(TBASE) \
+	X(OPTEMERGTSUM) X(TSUMLA_MIN) X(TSUMSBR) X(TSUMLLIFE) X(TSUMREDISTMAX) X(FINTSUM) \
+	X(LAI_MIN) X(WSOREDISTFRACMAX) X(WLVGNEWN) X(SO2LV) X(RRREDISTSO) X(DELREDIST) X(SLAII)
+
+// crop parameter tables: X(name, number of columns)
+#define LC_CROP_TABLES(X) \
+	X(FRACSLATB, 2) X(RDRT, 2) X(TTB, 2) X(FLVTB, 2) X(FSTTB, 2) X(FSOTB, 2) X(FRTTB, 2)
+
+// crop parameters that are only used by the NPK model
+#define LC_CROP_NPK_PARAMETERS(X) \
+	X(NLAI) X(RDRNS) X(K_MAX) X(K_NPK_NI) X(TSUM_NPKI) X(K_WATER) \
+	X(SLOPE_NEQ_SOILSUPPLY_NEQ_PLANTUPTAKE) X(FR_MAX) X(N_RECOV) X(P_RECOV) X(K_RECOV) \
+	X(NFLVD) X(PFLVD) X(KFLVD) X(TCNPKT) X(RTNMINF) X(RTPMINF) X(RTKMINF)
+
+#define LC_CROP_NPK_TABLES(X) \
+	X(NMINMAXLV, 3) X(PMINMAXLV, 3) X(KMINMAXLV, 3) X(NMINMAXST, 3) X(PMINMAXST, 3) X(KMINMAXST, 3) \
+	X(NMINMAXSO, 3) X(PMINMAXSO, 3) X(KMINMAXSO, 3) X(NMINMAXRT, 3) X(PMINMAXRT, 3) X(KMINMAXRT, 3)
+
+// soil parameters
+#define LC_SOIL_PARAMETERS(X) \
+	X(ROOTDM) X(WCAD) X(WCWP) X(WCFC) X(WCWET) X(WCST) X(DRATE)
+
+#define LC_SOIL_NPK_PARAMETERS(X) \
+	X(NMINI) X(PMINI) X(KMINI)
+
+// management (dates)
+#define LC_MANAGEMENT_PARAMETERS(X) \
+	X(PLDATE) X(HVDATE)
+
+#define LC_MANAGEMENT_NPK_TABLES(X) \
+	X(FERTAB, 4)
+
+// optional management parameters: X(name, default value)
+// irrigation (if water_limited): IRRAMOUNT (mm) is applied when the soil water content 
+// is below IRRFRAC times the critical water content, until IRRMAX (mm) has been applied
+#define LC_MANAGEMENT_OPTIONAL(X) \
+	X(IRRFRAC, 0) X(IRRAMOUNT, 0) X(IRRMAX, INFINITY)
+
+
+// state variables (and their rates): X(name, NPK model only)
+// the order is the order of the output
+#define LC_VARIABLES(X) \
+	X(ROOTD, 0)            /* m */ \
+	X(WA, 0)               /* mm */ \
+	X(TSUM, 0)             /* Deg. C d */ \
+	X(TSUMCROP, 0)         \
+	X(TSUMCROPLEAFAGE, 0)  \
+	X(DORMTSUM, 0)         \
+	X(PUSHDORMRECTSUM, 0)  \
+	X(PUSHREDISTENDTSUM, 0)\
+	X(DORMTIME, 0)         /* d */ \
+	X(WCUTTING, 0)         /* g DM m-2 */ \
+	X(TRAIN, 1)            /* mm */ \
+	X(PAR, 0)              /* MJ m-2 */ \
+	X(LAI, 0)              /* m2 m-2 */ \
+	X(WLVD, 0)             /* g DM m-2 */ \
+	X(WLV, 0)              \
+	X(WST, 0)              \
+	X(WSO, 0)              \
+	X(WRT, 0)              \
+	X(WLVG, 0)             \
+	X(TRAN, 0)             /* mm */ \
+	X(EVAP, 0)             \
+	X(PTRAN, 0)            \
+	X(PEVAP, 0)            \
+	X(RUNOFF, 0)           \
+	X(NINTC, 0)            \
+	X(DRAIN, 0)            \
+	X(REDISTLVG, 0)        /* g DM m-2 */ \
+	X(REDISTSO, 0)         \
+	X(PUSHREDISTSUM, 0)    /* Deg. C d */ \
+	X(WSOFASTRANSLSO, 0)   /* g DM m-2 */ \
+	X(IRRIG, 0)            /* mm */ \
+	X(NCUTTING, 1)         /* g N,P,K m-2 */ \
+	X(PCUTTING, 1)         \
+	X(KCUTTING, 1)         \
+	X(ANLVG, 1)            /* g N m-2 */ \
+	X(ANLVD, 1)            \
+	X(ANST, 1)             \
+	X(ANRT, 1)             \
+	X(ANSO, 1)             \
+	X(APLVG, 1)            /* g P m-2 */ \
+	X(APLVD, 1)            \
+	X(APST, 1)             \
+	X(APRT, 1)             \
+	X(APSO, 1)             \
+	X(AKLVG, 1)            /* g K m-2 */ \
+	X(AKLVD, 1)            \
+	X(AKST, 1)             \
+	X(AKRT, 1)             \
+	X(AKSO, 1)             \
+	X(NMINT, 1)            /* g N,P,K m-2 */ \
+	X(PMINT, 1)            \
+	X(KMINT, 1)            \
+	X(NMINS, 1)            \
+	X(PMINS, 1)            \
+	X(KMINS, 1)            \
+	X(NMINF, 1)            \
+	X(PMINF, 1)            \
+	X(KMINF, 1)
+
+#endif
@@ -0,0 +1,93 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <algorithm>
+#include "LINTcas.h"
+#include "parallel.h"
+
+
+static double runWSO(LINcasModel &m, double delt) {
+	m.control.DELT = delt;
+	m.reset();
+	if (!m.start()) return NAN;
+	while (m.step_day()) {}
+	return m.fatalError ? NAN : m.S.WSO;
+}
+
+
+// Screening of many parameter sets (as in a sweep) with a coarse time step of
+// "delt" days. Each set is also run with a time step of 2*delt days. The error
+// is about proportional to the time step, so the difference between the two
+// runs estimates the error of the first. The estimate is calibrated with the
+// sets in "sample", that are also run with daily time steps. The sets with an
+// estimated error larger than "tolerance" times the yield (WSO) are flagged
+// for a daily run
+bool LC_screening(const LINcasModel &base, const std::vector<int> &index, const std::vector<std::vector<double>> &values, unsigned delt, const std::vector<size_t> &sample, double tolerance, size_t nthreads, LINcasOutput &out, double &calibration, std::vector<std::string> &messages) {
+
+	if (delt < 1) {
+		messages.push_back("the time step must be at least one day");
+		return false;
+	}
+	if (base.control.NPKmodel) {
+		messages.push_back("the NPK model cannot be screened with coarse time steps");
+		return false;
+	}
+	size_t n = values.empty() ? 0 : values[0].size();
+	std::vector<bool> sampled(n, false);
+	for (size_t i : sample) {
+		if (i >= n) {
+			messages.push_back("sample index out of range");
+			return false;
+		}
+		sampled[i] = true;
+	}
+
+	// coarse, coarser, daily
+	std::vector<std::array<double, 3>> y(n, {NAN, NAN, NAN});
+	std::vector<std::vector<std::string>> msgs(n);
+	std::vector<LINcasModel> pool(std::max(size_t(1), nthreads));
+	std::vector<LINcasOverlay> overlays(pool.size());
+	for (LINcasOverlay &ov : overlays) {
+		for (int k : index) ov.values.push_back({k, 0});
+	}
+	LC_parallel(n, nthreads, [&](size_t i, size_t t) {
+		LINcasModel &m = pool[t];
+		LINcasOverlay &ov = overlays[t];
+		for (size_t j=0; j<values.size(); j++) {
+			ov.values[j].second = values[j][i];
+		}
+		ov.apply(base, m);
+		m.control.outvars = "batch";
+		m.management.harvests.clear();
+		y[i][0] = runWSO(m, delt);
+		msgs[i] = m.messages;
+		y[i][1] = runWSO(m, 2 * delt);
+		if (sampled[i]) {
+			y[i][2] = runWSO(m, 1);
+		}
+	});
+
+	// the ratio of the actual and the estimated error in the sample
+	double actual = 0, estimate = 0;
+	for (size_t i=0; i<n; i++) {
+		if (sampled[i] && (!std::isnan(y[i][2])) && (!std::isnan(y[i][1]))) {
+			actual += std::abs(y[i][2] - y[i][0]);
+			estimate += std::abs(y[i][1] - y[i][0]);
+		}
+	}
+	calibration = (estimate > 0) ? (actual / estimate) : 1;
+
+	out.names = {"set", "WSO", "error", "daily", "rerun"};
+	out.values.clear();
+	out.values.reserve(n * out.names.size());
+	for (size_t i=0; i<n; i++) {
+		double err = calibration * std::abs(y[i][1] - y[i][0]);
+		bool rerun = (!sampled[i]) && (std::isnan(err) || (err > (tolerance * std::abs(y[i][0]))));
+		out.values.insert(out.values.end(), {double(i + 1), y[i][0], err, y[i][2], double(rerun)});
+		messages.insert(messages.end(), msgs[i].begin(), msgs[i].end());
+	}
+	return true;
+}
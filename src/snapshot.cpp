@@ -0,0 +1,68 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include "LINTcas.h"
+
+
+LINcasSnapshot LINcasModel::snapshot() const {
+	LINcasSnapshot x;
+	x.S = S;
+	x.R = R;
+	x.step = step;
+	x.time = time;
+	x.season_length = season_length;
+	x.maxdur = maxdur;
+	x.nextharvest = nextharvest;
+	x.ended = ended;
+	x.emerged = emerged;
+	x.eventlog = eventlog;
+	x.RTNMINS = soil.RTNMINS;
+	x.RTPMINS = soil.RTPMINS;
+	x.RTKMINS = soil.RTKMINS;
+	x.wstate = wstate;
+	return x;
+}
+
+
+// continue from a snapshot. The output and messages are not changed 
+void LINcasModel::restore(const LINcasSnapshot &x) {
+	S = x.S;
+	R = x.R;
+	step = x.step;
+	time = x.time;
+	season_length = x.season_length;
+	maxdur = x.maxdur;
+	nextharvest = x.nextharvest;
+	ended = x.ended;
+	emerged = x.emerged;
+	eventlog = x.eventlog;
+	soil.RTNMINS = x.RTNMINS;
+	soil.RTPMINS = x.RTPMINS;
+	soil.RTKMINS = x.RTKMINS;
+	wstate = x.wstate;
+}
+
+
+// n copies of the model that continue from the current state. The copies
+// share the weather and the parameter tables with this model. The output of 
+// the copies only has the days after the fork
+std::vector<LINcasModel> LINcasModel::fork(size_t n) const {
+	std::vector<LINcasModel> f(n);
+	LINcasSnapshot x = snapshot();
+	LINcasOverlay ov;
+	for (LINcasModel &m : f) {
+		ov.apply(*this, m);
+		m.out.names = out.names;
+		m.out.variables = out.variables;
+		m.out.outvars = out.outvars;
+		m.out.NPKmodel = out.NPKmodel;
+		m.out.outnames = out.outnames;
+		m.out.harvests = out.harvests;
+		m.fatalError = fatalError;
+		m.restore(x);
+	}
+	return f;
+}
@@ -17,33 +17,39 @@ The drunir function computes rates of drainage, runoff and irrigation.
 #include "LINTcas.h"
 
 
-void LINcasModel::Penman() {
+// computed once for each time step (in weather_step), because the same 
+// weather can be used by several models (see LC_yield_gap)
+void LINcasAtmosphere::penmanTerms() {
   
-	double DTRJM2 = A.SRAD * 1E6;   // J m-2 d-1     :    Daily radiation in Joules 
+	double DTRJM2 = SRAD * 1E6;   // J m-2 d-1     :    Daily radiation in Joules 
 	double BOLTZM = 5.668E-8; 	    // J m-1 s-1 K-4 :    Stefan-Boltzmann constant 
 	double LHVAP  = 2.4E6;          // J kg-1        :    Latent heat of vaporization 
 	double PSYCH  = 0.067;          // kPa deg. C-1  :    Psychrometric constant
 	
-	double BBRAD  = BOLTZM * pow((A.TAVG+273), 4) * 86400;           // J m-2 d-1 : Black body radiation 
-	double SVP    = 0.611 * std::exp(17.4 * A.TAVG / (A.TAVG + 239)); // kPa : Saturation vapour pressure
-	double SLOPE  = 4158.6 * SVP / pow((A.TAVG + 239), 2);        // kPa dec. C-1:  Change of SVP per degree C
-	double RLWN   = BBRAD * std::max(0., 0.55 * (1 - A.VAPR / SVP)); // J m-2 d-1 : Net outgoing long-wave radiation
-	double WDF    = 2.63 * (1.0 + 0.54 * A.WIND);      // kg m-2 d-1 : Wind function in the Penman equation
+	double BBRAD  = BOLTZM * pow((TAVG+273), 4) * 86400;           // J m-2 d-1 : Black body radiation 
+	double SVP    = 0.611 * std::exp(17.4 * TAVG / (TAVG + 239)); // kPa : Saturation vapour pressure
+	double SLOPE  = 4158.6 * SVP / pow((TAVG + 239), 2);        // kPa dec. C-1:  Change of SVP per degree C
+	double RLWN   = BBRAD * std::max(0., 0.55 * (1 - VAPR / SVP)); // J m-2 d-1 : Net outgoing long-wave radiation
+	double WDF    = 2.63 * (1.0 + 0.54 * WIND);      // kg m-2 d-1 : Wind function in the Penman equation
 	
 	// Net radiation (J m-2 d-1) for soil (1) and crop (2)
 	double NRADS  = DTRJM2 * (1 - 0.15) - RLWN;     // (1)
 	double NRADC  = DTRJM2 * (1 - 0.25) - RLWN;     // (2)
 	
 	// Radiation terms (J m-2 d-1) of the Penman equation for soil (1) and crop (2)
-	double PENMRS = NRADS * SLOPE / (SLOPE + PSYCH);    // (1)
-	double PENMRC = NRADC * SLOPE / (SLOPE + PSYCH);    // (2)
+	PENMRS = NRADS * SLOPE / (SLOPE + PSYCH);    // (1)
+	PENMRC = NRADC * SLOPE / (SLOPE + PSYCH);    // (2)
 	
 	// Drying power term (J m-2 d-1) of the Penman equation
-	double PENMD  = LHVAP * WDF * (SVP - A.VAPR) * PSYCH / (SLOPE + PSYCH);
-	
+	PENMD  = LHVAP * WDF * (SVP - VAPR) * PSYCH / (SLOPE + PSYCH);
+}
+
+
+void LINcasModel::Penman() {
+	double LHVAP  = 2.4E6;          // J kg-1        :    Latent heat of vaporization 
 	// Potential evaporation and transpiration are weighed by a factor representing the plant canopy (exp(-0.5 * LAI)).
-	R.PEVAP  = std::exp(-0.5 * S.LAI)  * (PENMRS + PENMD) / LHVAP;       // mm d-1
-	double PTRAN  = (1 - std::exp(-0.5 * S.LAI)) * (PENMRC + PENMD) / LHVAP;  // mm d-1
+	R.PEVAP  = std::exp(-0.5 * S.LAI)  * (A.PENMRS + A.PENMD) / LHVAP;       // mm d-1
+	double PTRAN  = (1 - std::exp(-0.5 * S.LAI)) * (A.PENMRC + A.PENMD) / LHVAP;  // mm d-1
 	R.PTRAN  = std::max(0., PTRAN - 0.5 * R.NINTC);                     // mm d-1
 }
 
@@ -92,14 +98,14 @@ void LINcasModel::evaptr() {
 	double aux = EVAP + TRAN;    // mm d-1
 	//aux[aux <= 0] = 1;  // mm d-1
 	aux = aux <= 0 ? 1 : aux;
-	double AVAILF = std::min(1., (S.WA-WAAD)/(control.DELT*aux)); // mm
+	double AVAILF = std::min(1., (S.WA-WAAD)/(DELT*aux)); // mm
 	
 	R.EVAP = EVAP * AVAILF;
 	R.TRAN = TRAN * AVAILF;
 }
 
 
-void LINcasModel::drunir() {
+void LINcasModel::drunir(double WC, double WCCR) {
 	
 	// Soil water content      
 	// double WC   = 0.001 * WA / ROOTD;  // m3 m-3
@@ -110,19 +116,27 @@ void LINcasModel::drunir() {
 	// Drainage below the root zone occurs when the amount of water in the soil exceeds field capacity
 	// or when the amount of rainfall in excess of interception and evapotranspiration fills up soil
 	// water above field capacity.
-	double DRAIN = (S.WA-WAFC)/control.DELT + (A.PREC - (R.NINTC + R.EVAP + R.TRAN));  // mm d-1 
+	double DRAIN = (S.WA-WAFC)/DELT + (A.PREC - (R.NINTC + R.EVAP + R.TRAN));  // mm d-1 
 	R.DRAIN = std::min(soil.DRATE, std::max(0., DRAIN));              // mm d-1
 	
 	// Surface runoff occurs when the amount of soil water exceeds total saturation or when the amount
 	// of rainfall in excess of interception, evapotranspiration and drainage fills up soil water
 	// above total saturation.
-	R.RUNOFF = std::max(0., (S.WA - WAST) / control.DELT + (A.PREC - (R.NINTC + R.EVAP + R.TRAN + R.DRAIN))); // mm d-1
+	R.RUNOFF = std::max(0., (S.WA - WAST) / DELT + (A.PREC - (R.NINTC + R.EVAP + R.TRAN + R.DRAIN))); // mm d-1
 
 	// The irrigation rate is the extra amount of water that is needed to keep soil water at a fraction
 	// of field capacity. If (!water_limited) the field is irrigated every timestep to keep the amount 
 	// of water in the soil at field capacity.
-
-	 R.IRRIG = control.water_limited ? 0 : std::max(0., (WAFC - S.WA) / control.DELT - (A.PREC - (R.NINTC + R.EVAP + R.TRAN + R.DRAIN + R.RUNOFF))); // mm d-1 
+	// Otherwise there can be deficit irrigation: a fixed amount when the soil water content drops 
+	// below a fraction of the critical water content, until the seasonal maximum has been applied
+
+	if (!control.water_limited) {
+		R.IRRIG = std::max(0., (WAFC - S.WA) / DELT - (A.PREC - (R.NINTC + R.EVAP + R.TRAN + R.DRAIN + R.RUNOFF))); // mm d-1 
+	} else if ((management.IRRAMOUNT > 0) && (WC < (management.IRRFRAC * WCCR)) && ((S.IRRIG + management.IRRAMOUNT) <= management.IRRMAX)) {
+		R.IRRIG = management.IRRAMOUNT / DELT; // mm d-1
+	} else {
+		R.IRRIG = 0;
+	}
 	 
 }
 
@@ -0,0 +1,221 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "LINTcas.h"
+
+
+bool LINcasWeatherData::check(std::string &msg) const {
+	size_t n = date.size();
+	if (n == 0) {
+		msg = "no weather data";
+		return false;
+	}
+	if ((srad.size() != n) || (tmin.size() != n) || (tmax.size() != n) || 
+			(prec.size() != n) || (wind.size() != n) || (vapr.size() != n)) {
+		msg = "weather variables do not have the same length";
+		return false;
+	}
+	return true;
+}
+
+
+void LINcasWeather::set(std::shared_ptr<const LINcasWeatherData> d) {
+	data = d;
+	date = LINcasSpan<long>(d->date);
+	srad = LINcasSpan<double>(d->srad);
+	tmin = LINcasSpan<double>(d->tmin);
+	tmax = LINcasSpan<double>(d->tmax);
+	prec = LINcasSpan<double>(d->prec);
+	wind = LINcasSpan<double>(d->wind);
+	vapr = LINcasSpan<double>(d->vapr);
+}
+
+void LINcasWeather::set(std::shared_ptr<const LINcasWeatherData> d, size_t from) {
+	data = d;
+	size_t n = d->date.size() - from;
+	date = LINcasSpan<long>(d->date.data() + from, n);
+	srad = LINcasSpan<double>(d->srad.data() + from, n);
+	tmin = LINcasSpan<double>(d->tmin.data() + from, n);
+	tmax = LINcasSpan<double>(d->tmax.data() + from, n);
+	prec = LINcasSpan<double>(d->prec.data() + from, n);
+	wind = LINcasSpan<double>(d->wind.data() + from, n);
+	vapr = LINcasSpan<double>(d->vapr.data() + from, n);
+}
+
+
+LINcasWeatherTransform::LINcasWeatherTransform() {
+	for (int m=0; m<12; m++) {
+		dtmin[m] = 0;
+		dtmax[m] = 0;
+		fsrad[m] = 1;
+		fprec[m] = 1;
+		fwind[m] = 1;
+		fvapr[m] = 1;
+	}
+}
+
+void LINcasWeatherTransform::apply(long date, LINcasDay &d) const {
+	int m = LC_month(date);
+	if (rh) {
+		// the same relative humidity at the changed mean temperature
+		double t0 = 0.5 * (d.tmin + d.tmax);
+		double t1 = t0 + 0.5 * (dtmin[m] + dtmax[m]);
+		d.vapr *= SatVP(t1) / SatVP(t0);
+	}
+	d.tmin += dtmin[m];
+	d.tmax += dtmax[m];
+	d.srad *= fsrad[m];
+	d.prec *= fprec[m];
+	d.wind *= fwind[m];
+	d.vapr *= fvapr[m];
+}
+// the month (0-11) of a date (days since 1970-01-01)
+// from http://howardhinnant.github.io/date_algorithms.html (civil_from_days)
+int LC_month(long date) {
+	long z = date + 719468;
+	long era = (z >= 0 ? z : z - 146096) / 146097;
+	long doe = z - era * 146097;
+	long yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+	long doy = doe - (365*yoe + yoe/4 - yoe/100);
+	long mp = (5*doy + 2) / 153;
+	return mp < 10 ? mp + 2 : mp - 10;
+}
+
+// from http://howardhinnant.github.io/date_algorithms.html (days_from_civil)
+long LC_date(long y, long m, long d) {
+	y -= m <= 2;
+	long era = (y >= 0 ? y : y - 399) / 400;
+	long yoe = y - era * 400;
+	long doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+	long doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+
+// "yyyy-mm-dd", for messages
+std::string LC_date_string(long date) {
+	long z = date + 719468;
+	long era = (z >= 0 ? z : z - 146096) / 146097;
+	long doe = z - era * 146097;
+	long yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+	long doy = doe - (365*yoe + yoe/4 - yoe/100);
+	long mp = (5*doy + 2) / 153;
+	long d = doy - (153*mp + 2)/5 + 1;
+	long m = mp < 10 ? mp + 3 : mp - 9;
+	long y = yoe + era * 400 + (m <= 2);
+	char s[64];
+	std::snprintf(s, sizeof(s), "%04ld-%02ld-%02ld", y, m, d);
+	return s;
+}
+
+
+// the fields of a line of a csv file, without quotes and surrounding spaces
+static void csvFields(const char* s, const char* end, std::vector<std::string> &f) {
+	f.clear();
+	while (true) {
+		const char* e = std::find(s, end, ',');
+		const char* a = s;
+		const char* b = e;
+		while ((a < b) && ((*a == ' ') || (*a == '"'))) a++;
+		while ((b > a) && ((b[-1] == ' ') || (b[-1] == '"') || (b[-1] == '\r'))) b--;
+		f.push_back(std::string(a, b));
+		if (e == end) break;
+		s = e + 1;
+	}
+}
+
+// A date is either a number (days since 1970-01-01) or "yyyy-mm-dd"
+static bool csvDate(const std::string &s, long &date) {
+	long y, m, d;
+	char c;
+	if (std::sscanf(s.c_str(), "%ld-%ld-%ld%c", &y, &m, &d, &c) == 3) {
+		date = LC_date(y, m, d);
+		return true;
+	}
+	char* e;
+	double x = std::strtod(s.c_str(), &e);
+	if ((e == s.c_str()) || (*e != 0) || (x != std::floor(x))) return false;
+	date = long(x);
+	return true;
+}
+
+// missing values (empty or NA) are NAN
+static bool csvValue(const std::string &s, double &x) {
+	if (s.empty() || (s == "NA")) {
+		x = NAN;
+		return true;
+	}
+	char* e;
+	x = std::strtod(s.c_str(), &e);
+	return (e != s.c_str()) && (*e == 0);
+}
+
+
+bool LINcasWeatherData::read(const std::string &filename, std::string &msg) {
+	FILE* f = std::fopen(filename.c_str(), "rb");
+	if (f == nullptr) {
+		msg = "cannot open " + filename;
+		return false;
+	}
+	std::string txt;
+	char buf[65536];
+	size_t n;
+	while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+		txt.append(buf, n);
+	}
+	std::fclose(f);
+
+	const char* s = txt.data();
+	const char* end = s + txt.size();
+	const char* e = std::find(s, end, '\n');
+	std::vector<std::string> fields;
+	csvFields(s, e, fields);
+	const std::vector<std::string> vars = {"date", "srad", "tmin", "tmax", "prec", "wind", "vapr"};
+	std::vector<size_t> cols;
+	for (const std::string &v : vars) {
+		size_t k = 0;
+		for (; k<fields.size(); k++) {
+			std::string x = fields[k];
+			std::transform(x.begin(), x.end(), x.begin(), ::tolower);
+			if (x == v) break;
+		}
+		if (k == fields.size()) {
+			msg = filename + ": variable " + v + " not found";
+			return false;
+		}
+		cols.push_back(k);
+	}
+	size_t ncol = fields.size();
+
+	std::vector<double>* values[6] = {&srad, &tmin, &tmax, &prec, &wind, &vapr};
+	date.clear();
+	for (std::vector<double>* v : values) v->clear();
+	size_t line = 1;
+	for (s = e; s < end; s = e) {
+		s++;
+		e = std::find(s, end, '\n');
+		line++;
+		if ((s == e) || ((e - s == 1) && (*s == '\r'))) continue;
+		csvFields(s, e, fields);
+		long d;
+		bool ok = (fields.size() == ncol) && csvDate(fields[cols[0]], d);
+		if (ok) date.push_back(d);
+		for (size_t j=0; ok && (j<6); j++) {
+			double x;
+			ok = csvValue(fields[cols[j+1]], x);
+			values[j]->push_back(x);
+		}
+		if (!ok) {
+			msg = filename + ": cannot read line " + std::to_string(line);
+			return false;
+		}
+	}
+	return check(msg);
+}
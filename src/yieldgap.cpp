@@ -0,0 +1,93 @@
+/*
+Author: Robert Hijmans
+2026
+License: EUPL
+*/
+
+#include <algorithm>
+#include "LINTcas.h"
+
+
+// Yield gap analysis. The potential, water-limited, and (with the NPK model) 
+// nutrient-limited and water and nutrient-limited variants of a model are run 
+// together, day by day. The weather of each day (including the terms of the 
+// Penman equation that do not depend on the crop) is only processed once. 
+// Variants with multi-day time steps could not share the weather, as their 
+// steps differ, so a time step of one day is required.
+// The output has the states at harvest for each variant
+bool LC_yield_gap(const LINcasModel &base, LINcasOutput &out, std::vector<std::string> &messages) {
+
+	// water_limited, nutrient_limited
+	std::vector<std::array<bool, 2>> limits = {{false, false}, {true, false}};
+	if (base.control.NPKmodel) {
+		limits.push_back({false, true});
+		limits.push_back({true, true});
+	}
+	if (base.control.DELT != 1) {
+		messages.push_back("yield gaps require a time step (DELT) of one day");
+		return false;
+	}
+	size_t n = limits.size();
+	std::vector<LINcasModel> m(n);
+	LINcasOverlay ov;
+	for (size_t i=0; i<n; i++) {
+		ov.apply(base, m[i]);
+		m[i].control.water_limited = limits[i][0];
+		m[i].control.nutrient_limited = limits[i][1];
+		m[i].control.outvars = "batch";
+		m[i].management.harvests.clear();
+		m[i].reset();
+		if (!m[i].start()) {
+			messages = m[i].messages;
+			return false;
+		}
+	}
+
+	// all variants that have not ended are at the same day
+	LINcasModel* last = nullptr;
+	for (;;) {
+		LINcasModel* first = nullptr;
+		for (LINcasModel &x : m) {
+			if (x.ended) continue;
+			if (first == nullptr) {
+				// the weather is computed (or generated) by the first variant
+				if ((last != nullptr) && (last != &x)) {
+					x.wstate = last->wstate;
+				}
+				last = &x;
+				if ((x.step > x.maxdur) || (x.time >= x.weather.date.size()) || (!x.weather_step())) {
+					x.ended = true;
+					continue;
+				}
+				first = &x;
+			} else {
+				x.A = first->A;
+				x.DELT = first->DELT;
+			}
+			x.crop_step();
+		}
+		if (first == nullptr) break;
+	}
+
+	// a row for each variant (numbered from 1)
+	out.names = {"variant", "step"};
+	std::vector<double LINcasVariables::*> states;
+	for (const LINcasVariable &v : LC_variables()) {
+		if (v.npk && !base.control.NPKmodel) continue;
+		out.names.push_back(v.name);
+		states.push_back(v.value);
+	}
+	out.values.clear();
+	for (size_t i=0; i<n; i++) {
+		messages.insert(messages.end(), m[i].messages.begin(), m[i].messages.end());
+		if (m[i].fatalError) {
+			return false;
+		}
+		out.values.push_back(double(i + 1));
+		out.values.push_back(double(m[i].step));
+		for (double LINcasVariables::* s : states) {
+			out.values.push_back(m[i].S.*s);
+		}
+	}
+	return true;
+}